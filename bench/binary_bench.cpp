@@ -0,0 +1,44 @@
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/binary.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+std::vector<unsigned char> MakeBytes(std::size_t size) {
+  std::vector<unsigned char> bytes(size);
+  for (std::size_t i = 0; i < size; i++)
+    bytes[i] = static_cast<unsigned char>(i * 31 + (i >> 8));
+  return bytes;
+}
+
+// args: number of bytes
+void BM_EncodeBase64(benchmark::State& state) {
+  const std::vector<unsigned char> bytes =
+      MakeBytes(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    std::string encoded = YAML::EncodeBase64(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+
+void BM_DecodeBase64(benchmark::State& state) {
+  const std::vector<unsigned char> bytes =
+      MakeBytes(static_cast<std::size_t>(state.range(0)));
+  const std::string encoded = YAML::EncodeBase64(bytes.data(), bytes.size());
+
+  for (auto _ : state) {
+    std::vector<unsigned char> decoded = YAML::DecodeBase64(encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+
+BENCHMARK(BM_EncodeBase64)->Arg(64)->Arg(64 * 1024);
+BENCHMARK(BM_DecodeBase64)->Arg(64)->Arg(64 * 1024);
+}  // namespace
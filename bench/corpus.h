@@ -0,0 +1,171 @@
+#ifndef CORPUS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define CORPUS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstdint>
+#include <string>
+
+#include "yaml-cpp/refeventhandler.h"
+
+#include "benchmark/benchmark.h"
+
+namespace bench {
+class NullEventHandler : public YAML::RefEventHandler {
+ public:
+  using Mark = YAML::Mark;
+  using anchor_t = YAML::anchor_t;
+
+  void OnDocumentStart(const Mark&) override {}
+  void OnDocumentEnd() override {}
+  void OnNull(const Mark&, anchor_t) override {}
+  void OnAlias(const Mark&, anchor_t) override {}
+  void OnScalar(const Mark&, YAML::StringRef, anchor_t,
+                YAML::StringRef) override {}
+  void OnSequenceStart(const Mark&, YAML::StringRef, anchor_t,
+                       YAML::EmitterStyle::value) override {}
+  void OnSequenceEnd() override {}
+  void OnMapStart(const Mark&, YAML::StringRef, anchor_t,
+                  YAML::EmitterStyle::value) override {}
+  void OnMapEnd() override {}
+};
+
+// The shapes of synthetic documents; each is made of some number of items.
+enum Shape {
+  DeepNesting,
+  WideMap,
+  LongScalars,
+  BlockLiterals,
+  FlowJson,
+  Commented
+};
+
+// deep nesting: each item is a block map 32 levels deep
+inline std::string MakeDeepNesting(int items) {
+  std::string out;
+  for (int i = 0; i < items; i++) {
+    std::string indent;
+    for (int depth = 0; depth < 32; depth++) {
+      out += indent + (depth == 0 ? "item" + std::to_string(i) : "level") +
+             std::to_string(depth) + ":\n";
+      indent += "  ";
+    }
+    out += indent + "leaf: " + std::to_string(i) + "\n";
+  }
+  return out;
+}
+
+// wide map: one key per item
+inline std::string MakeWideMap(int items) {
+  std::string out;
+  for (int i = 0; i < items; i++)
+    out += "key" + std::to_string(i) + ": value " + std::to_string(i) + "\n";
+  return out;
+}
+
+// long scalars: a plain and a double-quoted scalar of about 1 KiB per item
+inline std::string MakeLongScalars(int items) {
+  std::string words;
+  while (words.size() < 1000)
+    words += "lorem ipsum dolor sit amet ";
+  words.pop_back();
+
+  std::string out;
+  for (int i = 0; i < items; i++) {
+    out += "- " + words + "\n";
+    out += "- \"" + words + " \\t\\u00e9 escaped\"\n";
+  }
+  return out;
+}
+
+// block literals: a literal and a folded scalar of 10 lines per item
+inline std::string MakeBlockLiterals(int items) {
+  std::string out;
+  for (int i = 0; i < items; i++) {
+    out += "- |\n";
+    for (int line = 0; line < 10; line++)
+      out += "  line " + std::to_string(line) + " of some literal text\n";
+    out += "- >-\n";
+    for (int line = 0; line < 10; line++)
+      out += "  line " + std::to_string(line) + " of some folded text\n";
+  }
+  return out;
+}
+
+// flow JSON-like: an array with one record per item
+inline std::string MakeFlowJson(int items) {
+  std::string out = "[";
+  for (int i = 0; i < items; i++) {
+    if (i > 0)
+      out += ",\n ";
+    out += "{\"id\": " + std::to_string(i) + ", \"name\": \"item " +
+           std::to_string(i) +
+           "\", \"tags\": [\"a\", \"b\"], \"score\": 1.5, \"ok\": true}";
+  }
+  out += "]\n";
+  return out;
+}
+
+// commented config: an indented section per item, with whole-line and
+// trailing comments on about half the lines
+inline std::string MakeCommented(int items) {
+  std::string out;
+  for (int i = 0; i < items; i++) {
+    out += "# ------------------------------------------------------------\n";
+    out += "# section " + std::to_string(i) + ": what it's for, and why\n";
+    out += "# ------------------------------------------------------------\n";
+    out += "section" + std::to_string(i) + ":\n";
+    out += "    # the name that's shown for it\n";
+    out += "    name: item " + std::to_string(i) + "    # must be unique\n";
+    out += "    enabled: true\n";
+    out += "\n";
+    out += "    # how many times to try, before giving up\n";
+    out += "    retries: 3\n";
+  }
+  return out;
+}
+
+inline std::string MakeCorpus(Shape shape, int items) {
+  switch (shape) {
+    case DeepNesting:
+      return MakeDeepNesting(items);
+    case WideMap:
+      return MakeWideMap(items);
+    case LongScalars:
+      return MakeLongScalars(items);
+    case BlockLiterals:
+      return MakeBlockLiterals(items);
+    case FlowJson:
+      return MakeFlowJson(items);
+    case Commented:
+      return MakeCommented(items);
+  }
+  return std::string();
+}
+
+inline const char* ShapeName(Shape shape) {
+  static const char* const names[] = {"deep",  "wide", "long",
+                                      "block", "flow", "commented"};
+  return names[shape];
+}
+
+// Labels a benchmark over a corpus, and counts its bytes.
+inline void SetCorpusCounters(benchmark::State& state, Shape shape,
+                              const std::string& input) {
+  state.SetLabel(ShapeName(shape));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(input.size()));
+}
+}  // namespace bench
+
+// args: shape, number of items
+#define BENCH_CORPUS_ARGS                                                 \
+  ArgsProduct({{bench::DeepNesting, bench::WideMap, bench::LongScalars,   \
+                bench::BlockLiterals, bench::FlowJson, bench::Commented}, \
+               {10, 1000}})
+
+#endif  // CORPUS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
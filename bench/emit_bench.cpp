@@ -0,0 +1,48 @@
+#include <string>
+
+#include "corpus.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "benchmark/benchmark.h"
+
+namespace {
+// args: shape, number of items; emits the loaded corpus
+void BM_EmitNode(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+  const YAML::Node node = YAML::Load(input);
+
+  for (auto _ : state) {
+    YAML::Emitter emitter;
+    emitter << node;
+    benchmark::DoNotOptimize(emitter.c_str());
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+// args: number of items; emits a list of small maps directly
+void BM_EmitEvents(benchmark::State& state) {
+  const int items = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    YAML::Emitter emitter;
+    emitter << YAML::BeginSeq;
+    for (int i = 0; i < items; i++) {
+      emitter << YAML::BeginMap;
+      emitter << YAML::Key << "id" << YAML::Value << i;
+      emitter << YAML::Key << "name" << YAML::Value << "some name";
+      emitter << YAML::Key << "score" << YAML::Value << i * 0.5;
+      emitter << YAML::Key << "tags" << YAML::Value << YAML::Flow
+              << YAML::BeginSeq << "a" << "b" << YAML::EndSeq;
+      emitter << YAML::EndMap;
+    }
+    emitter << YAML::EndSeq;
+    benchmark::DoNotOptimize(emitter.c_str());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * items);
+}
+
+BENCHMARK(BM_EmitNode)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_EmitEvents)->Arg(1000);
+}  // namespace
@@ -0,0 +1,127 @@
+#include <sstream>
+#include <string>
+
+#include "corpus.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "benchmark/benchmark.h"
+
+namespace {
+enum Encoding { Utf8, Utf16LE, Utf16BE, Utf32LE, Utf32BE };
+
+void Put(std::string& out, Encoding encoding, int ch) {
+  const auto byte = [](int b) {
+    return static_cast<char>(static_cast<unsigned char>(b & 0xFF));
+  };
+
+  switch (encoding) {
+    case Utf8:
+      if (ch <= 0x7F) {
+        out += byte(ch);
+      } else if (ch <= 0x7FF) {
+        out += byte(0xC0 | (ch >> 6));
+        out += byte(0x80 | (ch & 0x3F));
+      } else if (ch <= 0xFFFF) {
+        out += byte(0xE0 | (ch >> 12));
+        out += byte(0x80 | ((ch >> 6) & 0x3F));
+        out += byte(0x80 | (ch & 0x3F));
+      } else {
+        out += byte(0xF0 | (ch >> 18));
+        out += byte(0x80 | ((ch >> 12) & 0x3F));
+        out += byte(0x80 | ((ch >> 6) & 0x3F));
+        out += byte(0x80 | (ch & 0x3F));
+      }
+      break;
+    case Utf16LE:
+    case Utf16BE:
+      if (ch >= 0x10000) {
+        ch -= 0x10000;
+        Put(out, encoding, 0xD800 | (ch >> 10));
+        Put(out, encoding, 0xDC00 | (ch & 0x3FF));
+      } else if (encoding == Utf16LE) {
+        out += byte(ch);
+        out += byte(ch >> 8);
+      } else {
+        out += byte(ch >> 8);
+        out += byte(ch);
+      }
+      break;
+    case Utf32LE:
+      for (int shift = 0; shift < 32; shift += 8)
+        out += byte(ch >> shift);
+      break;
+    case Utf32BE:
+      for (int shift = 24; shift >= 0; shift -= 8)
+        out += byte(ch >> shift);
+      break;
+  }
+}
+
+void PutEntry(std::string& out, Encoding encoding, int startCh, int endCh) {
+  for (char ch : std::string("- |\n  "))
+    Put(out, encoding, ch);
+  for (int ch = startCh; ch <= endCh; ++ch)
+    Put(out, encoding, ch);
+  Put(out, encoding, '\n');
+}
+
+// The same blocks as test/integration/encoding_test.cpp, repeated: one
+// sequence of block literals, 'mostly ASCII' or not.
+std::string MakeCorpus(Encoding encoding, bool ascii, int repeat) {
+  std::string out;
+  Put(out, encoding, 0xFEFF);
+  for (int i = 0; i < repeat; i++) {
+    PutEntry(out, encoding, 0x0021, 0x007E);  // Basic Latin
+    if (ascii)
+      continue;
+    PutEntry(out, encoding, 0x00A1, 0x00FF);  // Latin-1 Supplement
+    PutEntry(out, encoding, 0x0660, 0x06FF);  // Arabic
+    PutEntry(out, encoding, 0x4E00, 0x4EFF);  // CJK unified ideographs
+    PutEntry(out, encoding, 0x103A0, 0x103C3);  // Old Persian
+  }
+  return out;
+}
+
+void SetLabel(benchmark::State& state, Encoding encoding, bool ascii) {
+  static const char* const names[] = {"utf8", "utf16le", "utf16be", "utf32le",
+                                      "utf32be"};
+  state.SetLabel(std::string(names[encoding]) + (ascii ? "/ascii" : "/mixed"));
+}
+
+// args: encoding, ascii only
+void BM_ParseEncodedStream(benchmark::State& state) {
+  const Encoding encoding = static_cast<Encoding>(state.range(0));
+  const bool ascii = state.range(1) != 0;
+  const std::string input = MakeCorpus(encoding, ascii, 200);
+
+  for (auto _ : state) {
+    std::stringstream stream(input);
+    YAML::Parser parser(stream);
+    bench::NullEventHandler handler;
+    parser.HandleNextDocument(handler);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(input.size()));
+  SetLabel(state, encoding, ascii);
+}
+
+void BM_ParseEncodedMemory(benchmark::State& state) {
+  const Encoding encoding = static_cast<Encoding>(state.range(0));
+  const bool ascii = state.range(1) != 0;
+  const std::string input = MakeCorpus(encoding, ascii, 200);
+
+  for (auto _ : state) {
+    YAML::Parser parser(input.data(), input.size());
+    bench::NullEventHandler handler;
+    parser.HandleNextDocument(handler);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(input.size()));
+  SetLabel(state, encoding, ascii);
+}
+
+BENCHMARK(BM_ParseEncodedStream)
+    ->ArgsProduct({{Utf8, Utf16LE, Utf16BE, Utf32LE, Utf32BE}, {1, 0}});
+BENCHMARK(BM_ParseEncodedMemory)
+    ->ArgsProduct({{Utf8, Utf16LE, Utf16BE, Utf32LE, Utf32BE}, {1, 0}});
+}  // namespace
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "corpus.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "benchmark/benchmark.h"
+
+namespace {
+// A sequence of the given number of scalars, of the type being converted to.
+template <typename T>
+YAML::Node MakeScalars(int items);
+
+template <>
+YAML::Node MakeScalars<int>(int items) {
+  YAML::Node node;
+  for (int i = 0; i < items; i++)
+    node.push_back(i * 7919);
+  return node;
+}
+
+template <>
+YAML::Node MakeScalars<double>(int items) {
+  YAML::Node node;
+  for (int i = 0; i < items; i++)
+    node.push_back(i * 0.3125 + 1e-3);
+  return node;
+}
+
+template <>
+YAML::Node MakeScalars<bool>(int items) {
+  YAML::Node node;
+  for (int i = 0; i < items; i++)
+    node.push_back(i % 2 == 0);
+  return node;
+}
+
+template <>
+YAML::Node MakeScalars<std::string>(int items) {
+  YAML::Node node;
+  for (int i = 0; i < items; i++)
+    node.push_back("string value " + std::to_string(i));
+  return node;
+}
+
+// args: number of scalars
+template <typename T>
+void BM_As(benchmark::State& state) {
+  const YAML::Node node = MakeScalars<T>(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    for (const YAML::Node& item : node) {
+      T value = item.as<T>();
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+
+// args: number of keys; looks up every one of them
+void BM_MapLookup(benchmark::State& state) {
+  const int items = static_cast<int>(state.range(0));
+  const YAML::Node node = YAML::Load(bench::MakeWideMap(items));
+  std::vector<std::string> keys;
+  for (int i = 0; i < items; i++)
+    keys.push_back("key" + std::to_string(i));
+
+  for (auto _ : state) {
+    for (const std::string& key : keys) {
+      YAML::Node value = node[key];
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * items);
+}
+
+// args: number of keys; looks up a key that isn't there
+void BM_MapLookupMissing(benchmark::State& state) {
+  const YAML::Node node =
+      YAML::Load(bench::MakeWideMap(static_cast<int>(state.range(0))));
+
+  for (auto _ : state) {
+    YAML::Node value = node["missing"];
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// Counts the scalars of a tree, reading each as a request handler would.
+template <typename N>
+std::size_t CountScalars(const N& node) {
+  if (node.IsScalar())
+    return node.Scalar().empty() ? 0 : 1;
+  std::size_t count = 0;
+  for (const auto& item : node) {
+    if (node.IsMap())
+      count += CountScalars<N>(item.first) + CountScalars<N>(item.second);
+    else
+      count += CountScalars<N>(item);
+  }
+  return count;
+}
+
+// args: shape of the corpus, number of items; walks the whole tree, with
+// Nodes, NodeViews or FrozenNodes
+template <typename N>
+void BM_Walk(benchmark::State& state) {
+  const auto shape = static_cast<bench::Shape>(state.range(0));
+  const YAML::Node node =
+      YAML::Load(bench::MakeCorpus(shape, static_cast<int>(state.range(1))));
+  const N root(node);
+
+  for (auto _ : state) {
+    std::size_t count = CountScalars(root);
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetLabel(bench::ShapeName(shape));
+}
+
+// args: number of items; each thread builds trees of its own, as the
+// workers of a server would, which shouldn't slow each other down
+void BM_BuildTrees(benchmark::State& state) {
+  const int items = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    YAML::Node node;
+    for (int i = 0; i < items; i++) {
+      YAML::Node item;
+      item.push_back(i);
+      item.push_back("value");
+      node.push_back(item);
+    }
+    benchmark::DoNotOptimize(node);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_As, int)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_As, double)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_As, bool)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_As, std::string)->Arg(1000);
+BENCHMARK(BM_MapLookup)->Arg(10)->Arg(1000)->Arg(50000);
+BENCHMARK(BM_MapLookupMissing)->Arg(10)->Arg(1000)->Arg(50000);
+BENCHMARK_TEMPLATE(BM_Walk, YAML::Node)
+    ->ArgsProduct({{bench::DeepNesting, bench::WideMap, bench::FlowJson},
+                   {1000}});
+BENCHMARK_TEMPLATE(BM_Walk, YAML::NodeView)
+    ->ArgsProduct({{bench::DeepNesting, bench::WideMap, bench::FlowJson},
+                   {1000}});
+BENCHMARK_TEMPLATE(BM_Walk, YAML::FrozenNode)
+    ->ArgsProduct({{bench::DeepNesting, bench::WideMap, bench::FlowJson},
+                   {1000}});
+BENCHMARK(BM_BuildTrees)->Arg(1000)->ThreadRange(1, 8)->UseRealTime();
+}  // namespace
@@ -0,0 +1,124 @@
+#include <string>
+#include <vector>
+
+#include "corpus.h"
+#include "scanner.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "benchmark/benchmark.h"
+
+namespace {
+void BM_Scan(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+
+  for (auto _ : state) {
+    YAML::Scanner scanner(input.data(), input.size());
+    while (!scanner.empty())
+      scanner.pop();
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+void BM_Parse(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+
+  for (auto _ : state) {
+    YAML::Parser parser(input.data(), input.size());
+    bench::NullEventHandler handler;
+    while (parser.HandleNextDocument(handler)) {
+    }
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+void BM_ParseOffsetMarks(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+
+  for (auto _ : state) {
+    YAML::Parser parser(input.data(), input.size(), YAML::MarkMode::Offset);
+    bench::NullEventHandler handler;
+    while (parser.HandleNextDocument(handler)) {
+    }
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+void BM_Load(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::Load(input);
+    benchmark::DoNotOptimize(node);
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+void BM_LoadInterned(benchmark::State& state) {
+  const bench::Shape shape = static_cast<bench::Shape>(state.range(0));
+  const std::string input =
+      bench::MakeCorpus(shape, static_cast<int>(state.range(1)));
+
+  for (auto _ : state) {
+    YAML::Node node = YAML::Load(input, YAML::Interning::Keys);
+    benchmark::DoNotOptimize(node);
+  }
+  bench::SetCorpusCounters(state, shape, input);
+}
+
+// A manifest with a few small keys that are wanted, and then large values
+// that aren't.
+std::string MakeManifest(int n) {
+  std::string out =
+      "kind: Deployment\n"
+      "metadata:\n"
+      "  name: web\n"
+      "spec:\n"
+      "  containers:\n"
+      "  - name: nginx\n"
+      "    image: \"nginx:1.25\"\n"
+      "  volumes:\n";
+  for (int i = 0; i < n; i++) {
+    out += "  - name: \"volume-" + std::to_string(i) + "\"\n";
+    out += "    configMap: {name: config, ";
+    out += "items: [{key: a, path: \"a\\tb\"}]}\n";
+    out += "    labels:\n      app: web\n      tier: 'front end'\n";
+  }
+  out += "status:\n  conditions:\n";
+  for (int i = 0; i < n; i++)
+    out += "  - type: Ready\n    message: \"pod \\\"" + std::to_string(i) +
+           "\\\" is ready\"\n";
+  return out;
+}
+
+// args: number of items, whether only the wanted keys are loaded
+void BM_LoadManifest(benchmark::State& state) {
+  const std::string input = MakeManifest(static_cast<int>(state.range(0)));
+  const bool selective = state.range(1) != 0;
+  const std::vector<std::vector<std::string>> paths = {
+      {"kind"}, {"metadata", "name"}, {"spec", "containers"}};
+
+  for (auto _ : state) {
+    YAML::Node node =
+        selective ? YAML::LoadPaths(input, paths) : YAML::Load(input);
+    benchmark::DoNotOptimize(node);
+  }
+  state.SetLabel(selective ? "paths" : "whole");
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(input.size()));
+}
+
+BENCHMARK(BM_Scan)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_Parse)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_ParseOffsetMarks)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_Load)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_LoadInterned)->BENCH_CORPUS_ARGS;
+BENCHMARK(BM_LoadManifest)->ArgsProduct({{1000}, {0, 1}});
+}  // namespace
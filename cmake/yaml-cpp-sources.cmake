@@ -12,9 +12,14 @@ set(yaml-cpp-sources
   src/emitter.cpp
   src/emitterstate.cpp
   src/emitterutils.cpp
+  src/eventreader.cpp
   src/exceptions.cpp
   src/exp.cpp
   src/fptostring.cpp
+  src/frozen.cpp
+  src/keyfilter.cpp
+  src/lineindex.cpp
+  src/mappedfile.cpp
   src/memory.cpp
   src/node.cpp
   src/node_data.cpp
@@ -24,6 +29,7 @@ set(yaml-cpp-sources
   src/ostream_wrapper.cpp
   src/parse.cpp
   src/parser.cpp
+  src/pushinput.cpp
   src/regex_yaml.cpp
   src/scanner.cpp
   src/scanscalar.cpp
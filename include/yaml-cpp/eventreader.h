@@ -0,0 +1,122 @@
+#ifndef EVENTREADER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENTREADER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+
+
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+
+
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/parser.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+class SingleDocParser;
+
+/**
+ * A single parsing event; these correspond to the calls on an
+ * {@code EventHandler}.
+ *
+ * The strings refer to the reader's own buffers, and are only valid until the
+ * next event is read.
+ */
+struct Event {
+  enum Type {
+    DocumentStart,
+    DocumentEnd,
+    Null,
+    Alias,
+    Scalar,
+    SequenceStart,
+    SequenceEnd,
+    MapStart,
+    MapEnd
+  };
+
+  Type type = DocumentStart;
+  Mark mark{};
+
+  /** The node's tag (for Scalar, SequenceStart and MapStart). */
+  StringRef tag{};
+
+  /** The scalar's value (for Scalar). */
+  StringRef value{};
+
+  /**
+   * The node's anchor (or, for an Alias, the anchor it refers to), and its
+   * name; NullAnchor and empty if there isn't one.
+   */
+  anchor_t anchor = NullAnchor;
+  StringRef anchorName{};
+
+  /** The collection's style (for SequenceStart and MapStart). */
+  EmitterStyle::value style = EmitterStyle::Default;
+};
+
+/**
+ * Reads the events of every document in its input, one at a time, as an
+ * alternative to having a {@code Parser} call an {@code EventHandler}.
+ */
+class YAML_CPP_API EventReader {
+ public:
+  /**
+   * Constructs a reader from the given input stream. The input stream must
+   * live as long as the reader.
+   */
+  explicit EventReader(std::istream& in);
+
+  /**
+   * Constructs a reader over the given buffer. The buffer is read in place
+   * and must live as long as the reader.
+   */
+  EventReader(const char* data, std::size_t size);
+
+  EventReader(const EventReader&) = delete;
+  EventReader(EventReader&&) = delete;
+  EventReader& operator=(const EventReader&) = delete;
+  EventReader& operator=(EventReader&&) = delete;
+  ~EventReader();
+
+  /**
+   * Reads the next event.
+   *
+   * @throw a ParserException on error.
+   * @return false if there are no more events
+   */
+  bool Next(Event& event);
+
+  /**
+   * Skips the rest of the sequence or map whose start was the last event read,
+   * up to and including its end. Does nothing after any other event.
+   *
+   * @throw a ParserException on error.
+   */
+  void Skip();
+
+ private:
+  Parser m_parser;
+  std::unique_ptr<SingleDocParser> m_pDocument;
+  Event::Type m_lastType;
+  bool m_done;
+  int m_docStartPos;
+};
+}  // namespace YAML
+
+#endif  // EVENTREADER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,62 @@
+#ifndef LINEINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define LINEINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+
+
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+
+
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+
+#include <cstddef>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+/**
+ * Finds the line and column of an offset in a UTF-8 buffer, as the parser
+ * would have counted them; that is, for the marks of a parser that was only
+ * keeping track of offsets (see {@link MarkMode}).
+ *
+ * The index of where each line starts is built the first time it's needed,
+ * and the buffer must live as long as the index.
+ */
+class YAML_CPP_API LineIndex {
+ public:
+  /** Indexes the given buffer, which may start with a byte order mark. */
+  LineIndex(const char* data, std::size_t size);
+  LineIndex(const LineIndex&) = default;
+  LineIndex& operator=(const LineIndex&) = default;
+
+  /**
+   * Returns the line ending that's counted: '\n' (for "\n" or "\r\n") or
+   * '\r', whichever comes first in the buffer.
+   */
+  char lineEnding() const { return m_lineEnding; }
+
+  /**
+   * Returns the given mark with its line and column filled in from its
+   * offset. Any mark that already has them (or that's null) is returned as
+   * it is.
+   */
+  Mark Locate(const Mark& mark) const;
+
+ private:
+  const char* m_pData;
+  std::size_t m_size;
+  char m_lineEnding;
+  mutable std::vector<std::size_t> m_lineStarts;  // empty until needed
+};
+}  // namespace YAML
+
+#endif  // LINEINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
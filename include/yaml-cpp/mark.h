@@ -19,6 +19,18 @@
 #include "yaml-cpp/dll.h"
 
 namespace YAML {
+/** What a parser keeps track of, for the mark of each thing it reads. */
+enum class MarkMode {
+  /** The offset, line and column (the default). */
+  LineColumn,
+
+  /**
+   * Only the offset, which is cheaper: the line and column are left -1, to
+   * be found from the input with a {@link LineIndex} when they're needed.
+   */
+  Offset
+};
+
 struct YAML_CPP_API Mark {
   Mark() : pos(0), line(0), column(0) {}
 
@@ -20,8 +20,13 @@
 #include "yaml-cpp/node/detail/node_data.h"
 
 #include <algorithm>
+#include <cstring>
 #include <type_traits>
 
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <string_view>
+#endif
+
 namespace YAML {
 namespace detail {
 template <typename Key, typename Enable = void>
@@ -105,6 +110,41 @@ struct remove_idx<Key,
   }
 };
 
+// string keys are equal to scalar keys with the same text, so they can be found
+// in a map's key index
+template <typename Key>
+inline bool get_scalar_key(const Key& /* key */, const char*& /* data */,
+                           std::size_t& /* size */) {
+  return false;
+}
+
+inline bool get_scalar_key(const std::string& key, const char*& data,
+                           std::size_t& size) {
+  data = key.data();
+  size = key.size();
+  return true;
+}
+
+inline bool get_scalar_key(const char* key, const char*& data,
+                           std::size_t& size) {
+  data = key;
+  size = std::strlen(key);
+  return true;
+}
+
+inline bool get_scalar_key(char* key, const char*& data, std::size_t& size) {
+  return get_scalar_key(static_cast<const char*>(key), data, size);
+}
+
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+inline bool get_scalar_key(std::string_view key, const char*& data,
+                           std::size_t& size) {
+  data = key.data();
+  size = key.size();
+  return true;
+}
+#endif
+
 template <typename T>
 inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
   T lhs;
@@ -133,18 +173,15 @@ inline node* node_data::get(const Key& key,
     case NodeType::Null:
       return nullptr;
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory))
+      if (node* pNode =
+              get_idx<Key>::get(m_pCollection->sequence, key, pMemory))
         return pNode;
       return nullptr;
     case NodeType::Scalar:
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-    return m.first->equals(key, pMemory);
-  });
-
-  return it != m_map.end() ? it->second : nullptr;
+  return find_map_pair(key, pMemory).second;
 }
 
 template <typename Key>
@@ -155,7 +192,8 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
     case NodeType::Undefined:
     case NodeType::Null:
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory)) {
+      if (node* pNode =
+              get_idx<Key>::get(get_collection().sequence, key, pMemory)) {
         m_type = NodeType::Sequence;
         return *pNode;
       }
@@ -166,42 +204,41 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-    return m.first->equals(key, pMemory);
-  });
-
-  if (it != m_map.end()) {
-    return *it->second;
+  refresh_key_index(pMemory);
+  const kv_pair pair = find_map_pair(key, pMemory);
+  if (pair.second) {
+    return *pair.second;
   }
 
   node& k = convert_to_node(key, pMemory);
   node& v = pMemory->create_node();
-  insert_map_pair(k, v);
+  insert_map_pair(k, v, pMemory);
   return v;
 }
 
 template <typename Key>
 inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
   if (m_type == NodeType::Sequence) {
-    return remove_idx<Key>::remove(m_sequence, key, m_seqSize);
+    return remove_idx<Key>::remove(m_pCollection->sequence, key,
+                                   m_pCollection->seqSize);
   }
 
   if (m_type == NodeType::Map) {
-    kv_pairs::iterator it = m_undefinedPairs.begin();
-    while (it != m_undefinedPairs.end()) {
+    collection& items = *m_pCollection;
+    kv_pairs::iterator it = items.undefinedPairs.begin();
+    while (it != items.undefinedPairs.end()) {
       kv_pairs::iterator jt = std::next(it);
       if (it->first->equals(key, pMemory)) {
-        m_undefinedPairs.erase(it);
+        items.undefinedPairs.erase(it);
       }
       it = jt;
     }
 
-    auto iter = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-      return m.first->equals(key, pMemory);
-    });
-
-    if (iter != m_map.end()) {
-      m_map.erase(iter);
+    refresh_key_index(pMemory);
+    const kv_pair pair = find_map_pair(key, pMemory);
+    if (pair.first) {
+      unindex_map_pair(pair);
+      items.map.erase(std::find(items.map.begin(), items.map.end(), pair));
       return true;
     }
   }
@@ -209,6 +246,25 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
   return false;
 }
 
+template <typename Key>
+inline node_data::kv_pair node_data::find_map_pair(
+    const Key& key, const shared_memory_holder& pMemory) const {
+  const char* scalar = nullptr;
+  std::size_t size = 0;
+  kv_pair pair;
+  if (get_scalar_key(key, scalar, size) &&
+      find_scalar_key(scalar, size, pair, pMemory)) {
+    return pair;
+  }
+
+  const node_map& map = m_pCollection->map;
+  auto it = std::find_if(map.begin(), map.end(), [&](const kv_pair m) {
+    return m.first->equals(key, pMemory);
+  });
+
+  return it != map.end() ? *it : kv_pair(nullptr, nullptr);
+}
+
 // map
 template <typename Key, typename Value>
 inline void node_data::force_insert(const Key& key, const Value& value,
@@ -227,7 +283,7 @@ inline void node_data::force_insert(const Key& key, const Value& value,
 
   node& k = convert_to_node(key, pMemory);
   node& v = convert_to_node(value, pMemory);
-  insert_map_pair(k, v, true);
+  insert_map_pair(k, v, pMemory, true);
 }
 
 template <typename T>
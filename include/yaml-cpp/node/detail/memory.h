@@ -16,7 +16,9 @@
 // IWYU pragma: friend "yaml-cpp/.*"
 
 
-#include <set>
+#include <cstddef>
+#include <memory>
+#include <string>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/ptr.h"
@@ -29,26 +31,134 @@ class node;
 
 namespace YAML {
 namespace detail {
+/**
+ * Allocates nodes (and anything else) from a few large blocks, which are only
+ * freed, along with all the nodes, when the arena is destroyed.
+ */
+class YAML_CPP_API arena {
+ public:
+  arena()
+      : m_pBlocks(nullptr),
+        m_pLastBlock(nullptr),
+        m_pCur(nullptr),
+        m_pEnd(nullptr),
+        m_nextBlockSize(kFirstBlockSize),
+        m_pNodes(nullptr),
+        m_pLastNode(nullptr),
+        m_pStrings(nullptr),
+        m_pLastStrings(nullptr),
+        m_size(0) {}
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+  ~arena();
+
+  /** Allocates {@code size} bytes, aligned for any type. */
+  void* allocate(std::size_t size);
+
+  node& create_node();
+
+  /** Returns a copy of {@code value}, which lasts as long as the arena. */
+  const std::string& create_string(const std::string& value);
+
+  /** Takes over everything {@code rhs} allocated, leaving it empty. */
+  void splice(arena& rhs);
+
+  /** The number of nodes created. */
+  std::size_t size() const { return m_size; }
+
+ private:
+  struct block;
+  struct node_entry;
+  struct string_block;
+
+  static const std::size_t kFirstBlockSize = 1024;
+  static const std::size_t kMaxBlockSize = 256 * 1024;
+  static const std::size_t kStringsPerBlock = 64;
+
+  block* m_pBlocks;
+  block* m_pLastBlock;
+  char* m_pCur;
+  char* m_pEnd;
+  std::size_t m_nextBlockSize;
+
+  node_entry* m_pNodes;
+  node_entry* m_pLastNode;
+  string_block* m_pStrings;  // the one being filled first
+  string_block* m_pLastStrings;
+  std::size_t m_size;
+};
+
 class YAML_CPP_API memory {
  public:
-  memory() : m_nodes{} {}
+  memory() : m_arena{}, m_sequence(0), m_keyChanges(0), m_pMergedInto{} {}
   node& create_node();
-  void merge(const memory& rhs);
+  void merge(memory& rhs);
   size_t size() const;
 
+  /**
+   * Returns a copy of {@code value} that lasts as long as the memory, for
+   * nodes to share (see {@code node::set_shared_scalar}).
+   */
+  const std::string& store_string(const std::string& value);
+
+  /**
+   * Returns the next number in a sequence that orders the nodes' changes
+   * (for {@code node::less}) deterministically: it's per memory, rather than
+   * global, so that threads building separate documents never share it.
+   */
+  size_t next_index() { return m_sequence++; }
+
  private:
-  using Nodes = std::set<shared_node>;
-  Nodes m_nodes;
+  friend class memory_holder;
+
+  arena m_arena;
+  size_t m_sequence;
+
+  // how many times a key in one of our maps' indexes has changed; an index
+  // that was built before the last change might have a key under its old
+  // scalar
+  size_t m_keyChanges;
+
+  // once merged into another memory, that one owns all our nodes (and any new
+  // ones go there too)
+  shared_memory m_pMergedInto;
 };
 
 class YAML_CPP_API memory_holder {
  public:
   memory_holder() : m_pMemory(std::make_shared<memory>()) {}
 
-  node& create_node() { return m_pMemory->create_node(); }
+  node& create_node() { return get().create_node(); }
   void merge(memory_holder& rhs);
+  size_t next_index() { return get().next_index(); }
+  const std::string& store_string(const std::string& value) {
+    return get().store_string(value);
+  }
+
+  /**
+   * Counts a change to a node that's a key in some map's index, so that the
+   * maps rebuild their indexes (see {@code key_changes}).
+   */
+  void count_key_change() { get().m_keyChanges++; }
+
+  /** Returns how many times a key in one of the maps' indexes has changed. */
+  size_t key_changes() const {
+    // (without get(), which updates m_pMemory, so that readers don't write)
+    const memory* pMemory = m_pMemory.get();
+    while (pMemory->m_pMergedInto)
+      pMemory = pMemory->m_pMergedInto.get();
+    return pMemory->m_keyChanges;
+  }
 
  private:
+  memory& get() {
+    while (m_pMemory->m_pMergedInto) {
+      shared_memory pMemory = m_pMemory->m_pMergedInto;
+      m_pMemory = std::move(pMemory);
+    }
+    return *m_pMemory;
+  }
+
   shared_memory m_pMemory;
 };
 }  // namespace detail
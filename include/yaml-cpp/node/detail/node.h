@@ -18,11 +18,12 @@
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node_ref.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/type.h"
+#include <memory>
 #include <set>
-#include <atomic>
 
 namespace YAML {
 namespace detail {
@@ -33,12 +34,12 @@ class node {
   };
 
  public:
-  node() : m_pRef(std::make_shared<node_ref>()), m_dependencies{}, m_index{} {}
+  explicit node(node_ref& ref) : m_pRef(&ref), m_pDependencies{}, m_index{} {}
   node(const node&) = delete;
   node& operator=(const node&) = delete;
 
   bool is(const node& rhs) const { return m_pRef == rhs.m_pRef; }
-  const node_ref* ref() const { return m_pRef.get(); }
+  const node_ref* ref() const { return m_pRef; }
 
   bool is_defined() const { return m_pRef->is_defined(); }
   const Mark& mark() const { return m_pRef->mark(); }
@@ -57,18 +58,27 @@ class node {
       return;
 
     m_pRef->mark_defined();
-    for (node* dependency : m_dependencies)
-      dependency->mark_defined();
-    m_dependencies.clear();
+    if (m_pDependencies) {
+      for (node* dependency : *m_pDependencies)
+        dependency->mark_defined();
+      m_pDependencies.reset();
+    }
   }
 
   void add_dependency(node& rhs) {
-    if (is_defined())
+    if (is_defined()) {
       rhs.mark_defined();
-    else
-      m_dependencies.insert(&rhs);
+      return;
+    }
+
+    if (!m_pDependencies)
+      m_pDependencies.reset(new nodes);
+    m_pDependencies->insert(&rhs);
   }
 
+  bool is_indexed_key() const { return m_pRef->is_indexed_key(); }
+  void mark_indexed_key() { m_pRef->mark_indexed_key(); }
+
   void set_ref(const node& rhs) {
     if (rhs.is_defined())
       mark_defined();
@@ -95,6 +105,10 @@ class node {
     mark_defined();
     m_pRef->set_scalar(scalar);
   }
+  void set_shared_scalar(const std::string& scalar) {
+    mark_defined();
+    m_pRef->set_shared_scalar(scalar);
+  }
   void set_tag(const std::string& tag) {
     mark_defined();
     m_pRef->set_tag(tag);
@@ -123,7 +137,7 @@ class node {
   void push_back(node& input, shared_memory_holder pMemory) {
     m_pRef->push_back(input, pMemory);
     input.add_dependency(*this);
-    m_index = m_amount.fetch_add(1);
+    m_index = pMemory->next_index();
   }
   void insert(node& key, node& value, shared_memory_holder pMemory) {
     m_pRef->insert(key, value, pMemory);
@@ -174,11 +188,12 @@ class node {
   }
 
  private:
-  shared_node_ref m_pRef;
+  node_ref* m_pRef;
+
+  // only undefined nodes have any (and most nodes never do)
   using nodes = std::set<node*, less>;
-  nodes m_dependencies;
-  size_t m_index;
-  static YAML_CPP_API std::atomic<size_t> m_amount;
+  std::unique_ptr<nodes> m_pDependencies;
+  size_t m_index;  // from its memory's sequence, when last pushed onto
 };
 }  // namespace detail
 }  // namespace YAML
@@ -18,6 +18,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,6 +42,7 @@ class YAML_CPP_API node_data {
   node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
+  ~node_data();
 
   void mark_defined();
   void set_mark(const Mark& mark);
@@ -48,15 +50,28 @@ class YAML_CPP_API node_data {
   void set_tag(const std::string& tag);
   void set_null();
   void set_scalar(const std::string& scalar);
+  /**
+   * Sets the scalar to {@code scalar} itself, rather than a copy, which must
+   * last as long as this does (e.g., a string kept by the memory).
+   */
+  void set_shared_scalar(const std::string& scalar);
   void set_style(EmitterStyle::value style);
 
+  /**
+   * Marks this as the data of a key in (at least) one map's key index, so
+   * that changing it makes the maps in its memory rebuild their indexes (see
+   * {@code memory_holder::count_key_change}).
+   */
+  void mark_indexed_key() { m_isIndexedKey = true; }
+  bool is_indexed_key() const { return m_isIndexedKey; }
+
   bool is_defined() const { return m_isDefined; }
   const Mark& mark() const { return m_mark; }
   NodeType::value type() const {
     return m_isDefined ? m_type : NodeType::Undefined;
   }
-  const std::string& scalar() const { return m_scalar; }
-  const std::string& tag() const { return m_tag; }
+  const std::string& scalar() const { return *m_pScalar; }
+  const std::string& tag() const;
   EmitterStyle::value style() const { return m_style; }
 
   // size/iterator
@@ -93,13 +108,59 @@ class YAML_CPP_API node_data {
   static const std::string& empty_scalar();
 
  private:
+  using kv_pair = std::pair<node*, node*>;
+  using node_seq = std::vector<node *>;
+  using node_map = std::vector<std::pair<node*, node*>>;
+  using kv_pairs = std::list<kv_pair>;
+  struct key_index;
+
+  // The items of a sequence or a map, which are only allocated once the node
+  // is one (so that scalars, which are most nodes, don't pay for them).
+  struct collection {
+    collection();
+    ~collection();
+
+    // sequence
+    node_seq sequence;
+    mutable std::size_t seqSize;
+
+    // map
+    node_map map;
+    mutable kv_pairs undefinedPairs;
+
+    // only built once the map is large
+    std::unique_ptr<key_index> pKeyIndex;
+  };
+
   void compute_seq_size() const;
   void compute_map_size() const;
 
   void reset_sequence();
   void reset_map();
+  collection& get_collection();
+
+  void insert_map_pair(node& key, node& value,
+                       const shared_memory_holder& pMemory, bool force = false);
 
-  void insert_map_pair(node& key, node& value, bool force = false);
+  /** Finds the (first) pair with the given key, or returns nulls. */
+  template <typename Key>
+  kv_pair find_map_pair(const Key& key,
+                        const shared_memory_holder& pMemory) const;
+
+  /**
+   * Looks up the pair whose key is the given scalar in the map's key index,
+   * setting {@code pair} to it (or to nulls if there's no such key).
+   *
+   * @return false if the index can't tell: there's no index, or more than one
+   *         key matches (and the first must be found in order)
+   */
+  bool find_scalar_key(const char* key, std::size_t size, kv_pair& pair,
+                       const shared_memory_holder& pMemory) const;
+  /** Rebuilds the map's key index, if a key has changed since it was built. */
+  void refresh_key_index(const shared_memory_holder& pMemory);
+  void build_key_index(const shared_memory_holder& pMemory);
+  void index_map_pair(const kv_pair& pair);
+  void unindex_map_pair(const kv_pair& pair);
   void convert_to_map(const shared_memory_holder& pMemory);
   void convert_sequence_to_map(const shared_memory_holder& pMemory);
 
@@ -107,28 +168,23 @@ class YAML_CPP_API node_data {
   static node& convert_to_node(const T& rhs, shared_memory_holder pMemory);
 
  private:
-  bool m_isDefined;
+  // the tags that nearly every node has, which aren't stored
+  enum tag_kind : unsigned char { NoTag, PlainTag, NonPlainTag, OtherTag };
+
   Mark m_mark;
   NodeType::value m_type;
-  std::string m_tag;
   EmitterStyle::value m_style;
+  bool m_isDefined;
+  tag_kind m_tagKind;
+  bool m_ownsScalar;  // or it's shared, and kept by the memory
+  bool m_isIndexedKey;
+  std::unique_ptr<std::string> m_pTag;  // for any other tag
 
   // scalar
-  std::string m_scalar;
-
-  // sequence
-  using node_seq = std::vector<node *>;
-  node_seq m_sequence;
+  const std::string* m_pScalar;
 
-  mutable std::size_t m_seqSize;
-
-  // map
-  using node_map = std::vector<std::pair<node*, node*>>;
-  node_map m_map;
-
-  using kv_pair = std::pair<node*, node*>;
-  using kv_pairs = std::list<kv_pair>;
-  mutable kv_pairs m_undefinedPairs;
+  // sequence or map
+  std::unique_ptr<collection> m_pCollection;
 };
 }
 }
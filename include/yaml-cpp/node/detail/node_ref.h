@@ -19,13 +19,17 @@
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node_data.h"
 
 namespace YAML {
 namespace detail {
+// The data that a node refers to, which (like the node and the data
+// themselves) lives in the node's memory, and which can be shared with other
+// nodes.
 class node_ref {
  public:
-  node_ref() : m_pData(std::make_shared<node_data>()) {}
+  explicit node_ref(node_data& data) : m_pData(&data) {}
   node_ref(const node_ref&) = delete;
   node_ref& operator=(const node_ref&) = delete;
 
@@ -36,7 +40,10 @@ class node_ref {
   const std::string& tag() const { return m_pData->tag(); }
   EmitterStyle::value style() const { return m_pData->style(); }
 
+  bool is_indexed_key() const { return m_pData->is_indexed_key(); }
+
   void mark_defined() { m_pData->mark_defined(); }
+  void mark_indexed_key() { m_pData->mark_indexed_key(); }
   void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
@@ -44,6 +51,9 @@ class node_ref {
   void set_tag(const std::string& tag) { m_pData->set_tag(tag); }
   void set_null() { m_pData->set_null(); }
   void set_scalar(const std::string& scalar) { m_pData->set_scalar(scalar); }
+  void set_shared_scalar(const std::string& scalar) {
+    m_pData->set_shared_scalar(scalar);
+  }
   void set_style(EmitterStyle::value style) { m_pData->set_style(style); }
 
   // size/iterator
@@ -99,7 +109,7 @@ class node_ref {
   }
 
  private:
-  shared_node_data m_pData;
+  node_data* m_pData;
 };
 }
 }
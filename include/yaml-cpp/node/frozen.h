@@ -0,0 +1,182 @@
+#ifndef NODE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+namespace detail {
+struct frozen_document;
+struct frozen_value;
+}  // namespace detail
+
+/**
+ * An immutable copy of a node, and everything below it, which any number of
+ * threads can read at once without a lock.
+ *
+ * Freezing copies the tree into a few flat arrays: one entry for each node
+ * and one buffer for all of the scalars. Nothing about a frozen node changes
+ * after that, and every one of its (const) accessors only reads, so it's
+ * safe to share one between threads, or to copy it (which shares the same
+ * document) and hand the copies out. Anything in the tree that isn't defined
+ * is left out, and a node that the tree reaches twice (through an alias) is
+ * frozen once.
+ *
+ * A key that isn't there gives a node that isn't defined, as with a const
+ * {@code Node}.
+ */
+class YAML_CPP_API FrozenNode {
+ public:
+  class const_iterator;
+  using iterator = const_iterator;
+
+  /** An empty (null) node. */
+  FrozenNode() : m_pDocument{}, m_index(0), m_isValid(true) {}
+  explicit FrozenNode(const Node& node);
+
+  YAML::Mark Mark() const;
+  NodeType::value Type() const;
+  bool IsDefined() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  // access; these convert a thawed copy, so they allocate
+  template <typename T>
+  T as() const {
+    return Thaw().template as<T>();
+  }
+  template <typename T, typename S>
+  T as(const S& fallback) const {
+    return m_isValid ? Thaw().template as<T>(fallback) : fallback;
+  }
+  /** The scalar, which lasts as long as the document. */
+  StringRef Scalar() const;
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  bool is(const FrozenNode& rhs) const;
+
+  /** Returns a new (mutable) copy of this node. */
+  Node Thaw() const;
+
+  // size/iterator
+  std::size_t size() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // indexing
+  FrozenNode operator[](StringRef key) const;
+  FrozenNode operator[](std::size_t index) const;
+
+ private:
+  FrozenNode(std::shared_ptr<const detail::frozen_document> pDocument,
+             std::uint32_t index)
+      : m_pDocument(std::move(pDocument)), m_index(index), m_isValid(true) {}
+
+  static FrozenNode Missing();
+
+ private:
+  std::shared_ptr<const detail::frozen_document> m_pDocument;
+  std::uint32_t m_index;
+  bool m_isValid;
+};
+
+/** Returns an immutable copy of the given node; see {@link FrozenNode}. */
+YAML_CPP_API FrozenNode Freeze(const Node& node);
+
+namespace detail {
+// An item of a sequence (the node itself) or of a map (first and second);
+// the parts that don't apply are undefined.
+struct frozen_value : public FrozenNode, std::pair<FrozenNode, FrozenNode> {
+  frozen_value() = default;
+  frozen_value(const FrozenNode& rhs, const FrozenNode& key,
+               const FrozenNode& value)
+      : FrozenNode(rhs), std::pair<FrozenNode, FrozenNode>(key, value) {}
+};
+}  // namespace detail
+
+class YAML_CPP_API FrozenNode::const_iterator {
+ private:
+  struct proxy {
+    explicit proxy(const detail::frozen_value& x) : m_ref(x) {}
+    const detail::frozen_value* operator->() const { return &m_ref; }
+
+    detail::frozen_value m_ref;
+  };
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = detail::frozen_value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  const_iterator() : m_node(), m_item(0) {}
+  const_iterator(const FrozenNode& node, std::size_t item)
+      : m_node(node), m_item(item) {}
+
+  const_iterator& operator++() {
+    ++m_item;
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator iterator_pre(*this);
+    ++(*this);
+    return iterator_pre;
+  }
+  const_iterator& operator--() {
+    --m_item;
+    return *this;
+  }
+  const_iterator operator--(int) {
+    const_iterator iterator_pre(*this);
+    --(*this);
+    return iterator_pre;
+  }
+
+  bool operator==(const const_iterator& rhs) const {
+    return m_item == rhs.m_item &&
+           m_node.m_pDocument == rhs.m_node.m_pDocument &&
+           m_node.m_index == rhs.m_node.m_index;
+  }
+  bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+  value_type operator*() const;
+  proxy operator->() const { return proxy(**this); }
+
+ private:
+  FrozenNode m_node;  // the collection
+  std::size_t m_item;
+};
+}  // namespace YAML
+
+#endif  // NODE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
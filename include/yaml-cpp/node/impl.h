@@ -255,16 +255,19 @@ inline void Node::Assign(const T& rhs) {
 template <>
 inline void Node::Assign(const std::string& rhs) {
   EnsureNodeExists();
+  CountKeyChange();
   m_pNode->set_scalar(rhs);
 }
 
 inline void Node::Assign(const char* rhs) {
   EnsureNodeExists();
+  CountKeyChange();
   m_pNode->set_scalar(rhs);
 }
 
 inline void Node::Assign(char* rhs) {
   EnsureNodeExists();
+  CountKeyChange();
   m_pNode->set_scalar(rhs);
 }
 
@@ -272,6 +275,7 @@ inline void Node::AssignData(const Node& rhs) {
   EnsureNodeExists();
   rhs.EnsureNodeExists();
 
+  CountKeyChange();
   m_pNode->set_data(*rhs.m_pNode);
   m_pMemory->merge(*rhs.m_pMemory);
 }
@@ -287,11 +291,17 @@ inline void Node::AssignNode(const Node& rhs) {
     return;
   }
 
+  CountKeyChange();
   m_pNode->set_ref(*rhs.m_pNode);
   m_pMemory->merge(*rhs.m_pMemory);
   m_pNode = rhs.m_pNode;
 }
 
+inline void Node::CountKeyChange() {
+  if (m_pNode->is_indexed_key())
+    m_pMemory->count_key_change();
+}
+
 // size/iterator
 inline std::size_t Node::size() const {
   if (!m_isValid)
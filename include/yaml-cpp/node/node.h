@@ -37,8 +37,10 @@ struct iterator_value;
 namespace YAML {
 class YAML_CPP_API Node {
  public:
+  friend class FrozenNode;
   friend class NodeBuilder;
   friend class NodeEvents;
+  friend class NodeView;
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
@@ -149,6 +151,12 @@ class YAML_CPP_API Node {
   void AssignData(const Node& rhs);
   void AssignNode(const Node& rhs);
 
+  /**
+   * Before this node changes: if it's a key in some map's index, makes the
+   * maps in its memory rebuild their indexes.
+   */
+  void CountKeyChange();
+
  private:
   bool m_isValid;
   // String representation of invalid key, if the node is invalid.
@@ -16,6 +16,7 @@
 // IWYU pragma: friend "yaml-cpp/.*"
 
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -32,6 +33,29 @@ class Node;
  */
 YAML_CPP_API Node Load(const std::string& input);
 
+/**
+ * Which of a loaded document's scalars share one copy of each string, rather
+ * than each having its own. That saves memory when the same keys (and, say,
+ * enum-like values) repeat many times, but it takes longer to load, since
+ * each one is looked up first.
+ */
+enum class Interning {
+  /** Every scalar has its own copy. */
+  None,
+  /** Equal map keys share one. */
+  Keys,
+  /** Equal map keys, and equal short scalars (of up to 32 bytes), share one. */
+  KeysAndShortScalars
+};
+
+/**
+ * Loads the input string as a single YAML document, whose equal scalars share
+ * their strings as given (see {@link Interning}).
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node Load(const std::string& input, Interning interning);
+
 /**
  * Loads the input string as a single YAML document.
  *
@@ -54,6 +78,55 @@ YAML_CPP_API Node Load(std::istream& input);
  */
 YAML_CPP_API Node LoadFile(const std::string& filename);
 
+/**
+ * Loads the input file as a single YAML document, whose equal scalars share
+ * their strings as given (see {@link Interning}).
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFile(const std::string& filename, Interning interning);
+
+/**
+ * Loads the input string as a single YAML document, as {@link Load} does, but
+ * if it's a large block map, builds its entries on up to {@code workers}
+ * threads at once (or, if that's 0, on as many as the hardware runs at once).
+ *
+ * The map is split first, before its keys at column 0; each thread then
+ * builds a run of whole entries, and they're all put together in order. The
+ * result is the same as {@link Load}'s, including any exception, since input
+ * that can't be split like that (e.g., with an alias to an earlier entry) is
+ * parsed again on one thread.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node LoadParallel(const std::string& input,
+                               std::size_t workers = 0);
+
+/**
+ * Loads the input file as a single YAML document, on up to {@code workers}
+ * threads at once, as {@link LoadParallel} does.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFileParallel(const std::string& filename,
+                                   std::size_t workers = 0);
+
+/**
+ * Loads only what's on the given key paths of the input string's first YAML
+ * document (see {@link Parser::HandleNextDocument}); so e.g. with
+ * {@code {{"spec", "containers"}}}, the result is a map with just a "spec",
+ * which is a map with just its "containers". The rest is skipped, mostly
+ * without being scanned, let alone loaded; unless what's kept has an alias to
+ * an anchor in it, in which case the whole document is loaded, and then the
+ * rest is removed.
+ *
+ * @throws {@link ParserException} if what's kept is malformed.
+ */
+YAML_CPP_API Node LoadPaths(const std::string& input,
+                            const std::vector<std::vector<std::string>>& paths);
+
 /**
  * Loads the input string as a list of YAML documents.
  *
@@ -82,6 +155,31 @@ YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+/**
+ * Loads the input string as a list of YAML documents, as {@link LoadAll}
+ * does, but parses them on up to {@code workers} threads at once (or, if
+ * that's 0, on as many as the hardware runs at once).
+ *
+ * The documents are found first, at the lines that start them with "---";
+ * each thread then parses a run of whole documents. The result is the same
+ * as {@link LoadAll}'s, including any exception, since input that can't be
+ * split like that (e.g., with directives) is parsed on one thread.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const std::string& input,
+                                               std::size_t workers = 0);
+
+/**
+ * Loads the input file as a list of YAML documents, on up to
+ * {@code workers} threads at once, as {@link LoadAllParallel} does.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API std::vector<Node> LoadAllFromFileParallel(
+    const std::string& filename, std::size_t workers = 0);
 }  // namespace YAML
 
 #endif  // VALUE_PARSE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
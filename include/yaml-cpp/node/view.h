@@ -0,0 +1,304 @@
+#ifndef NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+struct view_value;
+
+// Whether a T (say, a Node, or a container of them) can hold a Node; which,
+// converted from a view, would only borrow the document's memory.
+template <typename... Ts>
+struct any_holds_node : std::false_type {};
+template <typename T>
+struct holds_node;
+template <typename T, typename... Ts>
+struct any_holds_node<T, Ts...>
+    : std::integral_constant<bool, holds_node<T>::value ||
+                                       any_holds_node<Ts...>::value> {};
+
+template <typename T>
+struct holds_node : std::is_base_of<Node, T> {};
+template <template <typename...> class C, typename... Ts>
+struct holds_node<C<Ts...>> : any_holds_node<Ts...> {};
+template <typename T, std::size_t N>
+struct holds_node<std::array<T, N>> : holds_node<T> {};
+template <typename T, std::size_t N>
+struct holds_node<T[N]> : holds_node<T> {};
+}  // namespace detail
+
+/**
+ * A read-only view of a node, which borrows it from a {@code Node} rather
+ * than sharing its memory.
+ *
+ * Views, and everything reached through them, are only valid while the
+ * {@code Node} they came from (or another one of the same document) is alive
+ * and the document isn't changed. In exchange, copying, indexing and
+ * iterating them never touch a reference count, which makes walking a large
+ * tree several times faster than it is with {@code Node}s.
+ *
+ * A key that isn't there gives a view that isn't defined, as with a const
+ * {@code Node}; but it doesn't remember the key for the error message.
+ */
+class YAML_CPP_API NodeView {
+ public:
+  class const_iterator;
+  using iterator = const_iterator;
+
+  /** A view of an empty (null) node. */
+  NodeView() : m_isValid(true), m_pNode(nullptr), m_pMemory(nullptr) {}
+  explicit NodeView(const Node& node YAML_ATTRIBUTE_LIFETIME_BOUND)
+      : m_isValid(node.m_isValid),
+        m_pNode(node.m_pNode),
+        m_pMemory(node.m_pMemory.get()) {}
+
+  YAML::Mark Mark() const;
+  NodeType::value Type() const;
+  bool IsDefined() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  // access; not to a Node (or anything that holds one), since it'd only
+  // borrow the document, too
+  template <typename T>
+  T as() const {
+    static_assert(!detail::holds_node<T>::value,
+                  "a view can't be converted to a Node; use Node instead");
+    return node().template as<T>();
+  }
+  template <typename T, typename S>
+  T as(const S& fallback) const {
+    static_assert(!detail::holds_node<T>::value,
+                  "a view can't be converted to a Node; use Node instead");
+    return node().template as<T>(fallback);
+  }
+  const std::string& Scalar() const;
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  bool is(const NodeView& rhs) const;
+
+  // size/iterator
+  std::size_t size() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // indexing
+  template <typename Key>
+  NodeView operator[](const Key& key) const;
+
+ private:
+  NodeView(detail::node& node, detail::memory_holder* pMemory)
+      : m_isValid(true), m_pNode(&node), m_pMemory(pMemory) {}
+
+  static NodeView Missing();
+
+  /** A memory holder that doesn't own the memory (so copies are free). */
+  detail::shared_memory_holder memory() const {
+    return detail::shared_memory_holder(detail::shared_memory_holder(),
+                                        m_pMemory);
+  }
+  /** A {@code Node} for this view, for conversions; it borrows too. */
+  Node node() const;
+
+ private:
+  bool m_isValid;
+  detail::node* m_pNode;
+  detail::memory_holder* m_pMemory;
+};
+
+namespace detail {
+// An item of a sequence (the view itself) or of a map (first and second);
+// the parts that don't apply are undefined.
+struct view_value : public NodeView, std::pair<NodeView, NodeView> {
+  view_value() = default;
+  view_value(const NodeView& rhs, const NodeView& key, const NodeView& value)
+      : NodeView(rhs), std::pair<NodeView, NodeView>(key, value) {}
+};
+}  // namespace detail
+
+class NodeView::const_iterator {
+ private:
+  struct proxy {
+    explicit proxy(const detail::view_value& x) : m_ref(x) {}
+    const detail::view_value* operator->() const { return &m_ref; }
+
+    detail::view_value m_ref;
+  };
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = detail::view_value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  const_iterator() : m_iterator(), m_pMemory(nullptr) {}
+  const_iterator(detail::node_iterator rhs, detail::memory_holder* pMemory)
+      : m_iterator(rhs), m_pMemory(pMemory) {}
+
+  const_iterator& operator++() {
+    ++m_iterator;
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator iterator_pre(*this);
+    ++(*this);
+    return iterator_pre;
+  }
+  const_iterator& operator--() {
+    --m_iterator;
+    return *this;
+  }
+  const_iterator operator--(int) {
+    const_iterator iterator_pre(*this);
+    --(*this);
+    return iterator_pre;
+  }
+
+  bool operator==(const const_iterator& rhs) const {
+    return m_iterator == rhs.m_iterator;
+  }
+  bool operator!=(const const_iterator& rhs) const {
+    return m_iterator != rhs.m_iterator;
+  }
+
+  value_type operator*() const {
+    const detail::node_iterator::value_type& v = *m_iterator;
+    if (v.pNode)
+      return value_type(NodeView(*v, m_pMemory), Missing(), Missing());
+    if (v.first && v.second)
+      return value_type(Missing(), NodeView(*v.first, m_pMemory),
+                        NodeView(*v.second, m_pMemory));
+    return value_type();
+  }
+  proxy operator->() const { return proxy(**this); }
+
+ private:
+  detail::node_iterator m_iterator;
+  detail::memory_holder* m_pMemory;
+};
+
+inline NodeView NodeView::Missing() {
+  NodeView view;
+  view.m_isValid = false;
+  return view;
+}
+
+inline Node NodeView::node() const {
+  if (!m_isValid)
+    return Node(Node::ZombieNode);
+  return m_pNode ? Node(*m_pNode, memory()) : Node();
+}
+
+inline Mark NodeView::Mark() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->mark() : Mark::null_mark();
+}
+
+inline NodeType::value NodeView::Type() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->type() : NodeType::Null;
+}
+
+inline bool NodeView::IsDefined() const {
+  if (!m_isValid)
+    return false;
+  return m_pNode ? m_pNode->is_defined() : true;
+}
+
+inline const std::string& NodeView::Scalar() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->scalar() : detail::node_data::empty_scalar();
+}
+
+inline const std::string& NodeView::Tag() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->tag() : detail::node_data::empty_scalar();
+}
+
+inline EmitterStyle::value NodeView::Style() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->style() : EmitterStyle::Default;
+}
+
+inline bool NodeView::is(const NodeView& rhs) const {
+  if (!m_isValid || !rhs.m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pNode || !rhs.m_pNode)
+    return false;
+  return m_pNode->is(*rhs.m_pNode);
+}
+
+inline std::size_t NodeView::size() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pNode ? m_pNode->size() : 0;
+}
+
+inline NodeView::const_iterator NodeView::begin() const {
+  if (!m_isValid || !m_pNode)
+    return const_iterator();
+  return const_iterator(m_pNode->begin(), m_pMemory);
+}
+
+inline NodeView::const_iterator NodeView::end() const {
+  if (!m_isValid || !m_pNode)
+    return const_iterator();
+  return const_iterator(m_pNode->end(), m_pMemory);
+}
+
+template <typename Key>
+inline NodeView NodeView::operator[](const Key& key) const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pNode)
+    return Missing();
+  detail::node* value =
+      static_cast<const detail::node&>(*m_pNode).get(key, memory());
+  return value ? NodeView(*value, m_pMemory) : Missing();
+}
+}  // namespace YAML
+
+#endif  // NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
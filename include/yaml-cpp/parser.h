@@ -16,15 +16,22 @@
 // IWYU pragma: friend "yaml-cpp/.*"
 
 
+#include <cstddef>
 #include <istream>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
 
 namespace YAML {
 class EventHandler;
+class KeyFilter;
 class Node;
+class PushInput;
+class RefEventHandler;
 class Scanner;
 struct Directives;
 struct Token;
@@ -49,6 +56,17 @@ class YAML_CPP_API Parser {
    */
   explicit Parser(std::istream& in);
 
+  /**
+   * Constructs a parser over the given buffer. The buffer is read in place
+   * and must live as long as the parser.
+   *
+   * If it's in UTF-8, its marks can be only offsets (see {@link MarkMode});
+   * the line and column are then still filled in for any
+   * {@link ParserException}, but nowhere else.
+   */
+  Parser(const char* data, std::size_t size,
+         MarkMode marks = MarkMode::LineColumn);
+
   ~Parser();
 
   /** Evaluates to true if the parser has some valid input to be read. */
@@ -60,6 +78,50 @@ class YAML_CPP_API Parser {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given buffer. Any existing state is erased.
+   * The buffer is read in place and must live as long as the parser; and its
+   * marks are kept as with the constructor.
+   */
+  void Load(const char* data, std::size_t size,
+            MarkMode marks = MarkMode::LineColumn);
+
+  /**
+   * Resets the parser to be fed its input in chunks, with {@code Feed} and
+   * {@code Finish}. Any existing state is erased.
+   *
+   * Every document in the input is handled by calling events on the
+   * {@code eventHandler} once they can be determined. Those events are only
+   * ever sent during {@code Feed} or {@code Finish}, on the calling thread.
+   *
+   * The parser stops wherever the fed input runs out, and carries on from
+   * there with the next chunk: so each event is sent as soon as there's
+   * enough input for it. Only the input from the start of the token that
+   * the scanner is on is kept. A token that goes on past a chunk is scanned
+   * again from its start once the input kept has doubled, so even a long one
+   * is only scanned a few times over in all.
+   */
+  void Load(EventHandler& eventHandler);
+
+  /**
+   * Takes the next chunk of input, which needn't end on any particular
+   * boundary, and sends the events that it completes (see above). The chunk
+   * is copied, so it needn't outlive the call. Does nothing unless the parser
+   * was loaded with an event handler.
+   *
+   * @throw a ParserException on error (or whatever the event handler throws),
+   *        after which any further input is ignored.
+   */
+  void Feed(const char* data, std::size_t size);
+
+  /**
+   * Signals the end of the input that's being fed to the parser, and returns
+   * once the last document has been handled.
+   *
+   * @throw a ParserException on error.
+   */
+  void Finish();
+
   /**
    * Handles the next document by calling events on the {@code eventHandler}.
    *
@@ -68,9 +130,45 @@ class YAML_CPP_API Parser {
    */
   bool HandleNextDocument(EventHandler& eventHandler);
 
+  /**
+   * Handles the next document by calling events on the {@code eventHandler},
+   * whose strings refer to the parser's own buffers.
+   *
+   * @throw a ParserException on error.
+   * @return false if there are no more documents
+   */
+  bool HandleNextDocument(RefEventHandler& eventHandler);
+
+  /**
+   * Handles the next document by calling events on the {@code eventHandler},
+   * but only for what's on the given key paths (like {@code {"spec",
+   * "containers"}}): a map on a path keeps just the entries whose (scalar)
+   * keys come next on some path, a sequence passes the paths on to each of
+   * its items, and the value at the end of a path is kept whole.
+   *
+   * The rest is skipped without any events, and without being checked. The
+   * values of a block map, if the parser reads a buffer in place, aren't even
+   * scanned into tokens, but matched up by their indentation. Since anchors
+   * in what's skipped aren't seen, an alias that refers to one is an error
+   * here (though {@link LoadPaths} loads the whole document instead).
+   *
+   * @throw a ParserException on error.
+   * @return false if there are no more documents
+   */
+  bool HandleNextDocument(EventHandler& eventHandler,
+                          const std::vector<std::vector<std::string>>& paths);
+
   void PrintTokens(std::ostream& out);
 
  private:
+  friend class EventReader;
+  friend class PushInput;
+
+  /** Handles the next document, with either kind of event handler. */
+  template <typename Handler>
+  bool HandleDocument(Handler& eventHandler,
+                      const KeyFilter* filter = nullptr);
+
   /**
    * Reads any directives that are next in the queue, setting the internal
    * {@code m_pDirectives} state.
@@ -94,6 +192,7 @@ class YAML_CPP_API Parser {
  private:
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
+  std::unique_ptr<PushInput> m_pPushInput;
 };
 }  // namespace YAML
 
@@ -0,0 +1,55 @@
+#ifndef REFEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define REFEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+
+
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+
+
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+struct Mark;
+
+/**
+ * Like an {@code EventHandler}, but its strings refer to the parser's own
+ * buffers (and are only valid during the call), so that they're never copied
+ * for a handler that only looks at some of them.
+ */
+class RefEventHandler {
+ public:
+  virtual ~RefEventHandler() = default;
+
+  virtual void OnDocumentStart(const Mark& mark) = 0;
+  virtual void OnDocumentEnd() = 0;
+
+  virtual void OnNull(const Mark& mark, anchor_t anchor) = 0;
+  virtual void OnAlias(const Mark& mark, anchor_t anchor) = 0;
+  virtual void OnScalar(const Mark& mark, StringRef tag, anchor_t anchor,
+                        StringRef value) = 0;
+
+  virtual void OnSequenceStart(const Mark& mark, StringRef tag,
+                               anchor_t anchor, EmitterStyle::value style) = 0;
+  virtual void OnSequenceEnd() = 0;
+
+  virtual void OnMapStart(const Mark& mark, StringRef tag, anchor_t anchor,
+                          EmitterStyle::value style) = 0;
+  virtual void OnMapEnd() = 0;
+
+  virtual void OnAnchor(const Mark& /*mark*/, StringRef /*anchor_name*/) {}
+};
+}  // namespace YAML
+
+#endif  // REFEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
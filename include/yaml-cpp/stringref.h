@@ -0,0 +1,75 @@
+#ifndef STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+
+
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+
+
+#endif
+
+// IWYU pragma: private, include "yaml-cpp/yaml.h"
+// IWYU pragma: friend "yaml-cpp/.*"
+
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <string_view>
+#endif
+
+namespace YAML {
+/**
+ * A reference to a string owned by someone else, like (and, from C++17,
+ * convertible to) a {@code std::string_view}.
+ */
+class StringRef {
+ public:
+  StringRef() : m_data(""), m_size(0) {}
+  StringRef(const char* data, std::size_t size) : m_data(data), m_size(size) {}
+  StringRef(const char* str) : m_data(str), m_size(std::strlen(str)) {}
+  StringRef(const std::string& str) : m_data(str.data()), m_size(str.size()) {}
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const char* begin() const { return m_data; }
+  const char* end() const { return m_data + m_size; }
+  char operator[](std::size_t i) const { return m_data[i]; }
+
+  std::string str() const { return std::string(m_data, m_size); }
+  explicit operator std::string() const { return str(); }
+
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+  operator std::string_view() const { return std::string_view(m_data, m_size); }
+#endif
+
+ private:
+  const char* m_data;
+  std::size_t m_size;
+};
+
+inline bool operator==(const StringRef& lhs, const StringRef& rhs) {
+  return lhs.size() == rhs.size() &&
+         (lhs.size() == 0 ||
+          std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+
+inline bool operator!=(const StringRef& lhs, const StringRef& rhs) {
+  return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out, const StringRef& str) {
+  return out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+}  // namespace YAML
+
+#endif  // STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
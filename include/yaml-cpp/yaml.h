@@ -10,6 +10,9 @@
 // IWYU pragma: begin_exports
 
 #include "yaml-cpp/parser.h"  // IWYU pragma: export
+#include "yaml-cpp/lineindex.h"  // IWYU pragma: export
+#include "yaml-cpp/eventreader.h"  // IWYU pragma: export
+#include "yaml-cpp/stringref.h"  // IWYU pragma: export
 #include "yaml-cpp/emitter.h"  // IWYU pragma: export
 #include "yaml-cpp/emitterstyle.h"  // IWYU pragma: export
 #include "yaml-cpp/stlemitter.h"  // IWYU pragma: export
@@ -19,6 +22,8 @@
 #include "yaml-cpp/node/impl.h"  // IWYU pragma: export
 #include "yaml-cpp/node/convert.h"  // IWYU pragma: export
 #include "yaml-cpp/node/iterator.h"  // IWYU pragma: export
+#include "yaml-cpp/node/view.h"  // IWYU pragma: export
+#include "yaml-cpp/node/frozen.h"  // IWYU pragma: export
 #include "yaml-cpp/node/detail/impl.h"  // IWYU pragma: export
 #include "yaml-cpp/node/parse.h"  // IWYU pragma: export
 #include "yaml-cpp/node/emit.h"  // IWYU pragma: export
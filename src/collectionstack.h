@@ -7,35 +7,10 @@
 #pragma once
 #endif
 
-#include <cassert>
-#include <stack>
-
 namespace YAML {
 struct CollectionType {
   enum value { NoCollection, BlockMap, BlockSeq, FlowMap, FlowSeq, CompactMap };
 };
-
-class CollectionStack {
- public:
-  CollectionStack() : collectionStack{} {}
-  CollectionType::value GetCurCollectionType() const {
-    if (collectionStack.empty())
-      return CollectionType::NoCollection;
-    return collectionStack.top();
-  }
-
-  void PushCollectionType(CollectionType::value type) {
-    collectionStack.push(type);
-  }
-  void PopCollectionType(CollectionType::value type) {
-    assert(type == GetCurCollectionType());
-    (void)type;
-    collectionStack.pop();
-  }
-
- private:
-  std::stack<CollectionType::value> collectionStack;
-};
 }  // namespace YAML
 
 #endif  // COLLECTIONSTACK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,74 @@
+#include "yaml-cpp/eventreader.h"
+
+#include "directives.h"  // IWYU pragma: keep
+#include "scanner.h"
+#include "singledocparser.h"
+#include "token.h"
+
+namespace YAML {
+EventReader::EventReader(std::istream& in)
+    : m_parser(in),
+      m_pDocument{},
+      m_lastType(Event::DocumentEnd),
+      m_done(false),
+      m_docStartPos(0) {}
+
+EventReader::EventReader(const char* data, std::size_t size)
+    : m_parser(data, size),
+      m_pDocument{},
+      m_lastType(Event::DocumentEnd),
+      m_done(false),
+      m_docStartPos(0) {}
+
+EventReader::~EventReader() = default;
+
+bool EventReader::Next(Event& event) {
+  while (!m_done) {
+    if (!m_pDocument) {
+      Scanner& scanner = *m_parser.m_pScanner;
+      m_parser.ParseDirectives();
+      if (scanner.empty()) {
+        m_done = true;
+        break;
+      }
+
+      m_docStartPos = scanner.peek().mark.pos;
+      m_pDocument.reset(new SingleDocParser(scanner, *m_parser.m_pDirectives));
+    }
+
+    if (m_pDocument->HandleNextEvent(event)) {
+      m_lastType = event.type;
+      return true;
+    }
+    m_pDocument.reset();
+
+    // as in Parser::HandleNextDocument, stop if no progress was made
+    Scanner& scanner = *m_parser.m_pScanner;
+    if (!scanner.empty() && scanner.peek().mark.pos == m_docStartPos)
+      m_done = true;
+  }
+
+  return false;
+}
+
+void EventReader::Skip() {
+  if (m_lastType != Event::SequenceStart && m_lastType != Event::MapStart)
+    return;
+
+  Event event;
+  for (int depth = 1; depth > 0 && Next(event);) {
+    switch (event.type) {
+      case Event::SequenceStart:
+      case Event::MapStart:
+        depth++;
+        break;
+      case Event::SequenceEnd:
+      case Event::MapEnd:
+        depth--;
+        break;
+      default:
+        break;
+    }
+  }
+}
+}  // namespace YAML
@@ -16,131 +16,139 @@
 namespace YAML {
 ////////////////////////////////////////////////////////////////////////////////
 // Here we store a bunch of expressions for matching different parts of the
-// file.
+// file. Each is compiled, so that matching it against the stream is mostly a
+// table lookup.
 
 namespace Exp {
 // misc
 inline const RegEx& Empty() {
-  static const RegEx e;
+  static const RegEx e = RegEx().Compiled();
   return e;
 }
 inline const RegEx& Space() {
-  static const RegEx e = RegEx(' ');
+  static const RegEx e = RegEx(' ').Compiled();
   return e;
 }
 inline const RegEx& Tab() {
-  static const RegEx e = RegEx('\t');
+  static const RegEx e = RegEx('\t').Compiled();
   return e;
 }
 inline const RegEx& Blank() {
-  static const RegEx e = Space() | Tab();
+  static const RegEx e = (Space() | Tab()).Compiled();
   return e;
 }
 inline const RegEx& Break() {
-  static const RegEx e = RegEx('\n') | RegEx("\r\n") | RegEx('\r');
+  static const RegEx e = (RegEx('\n') | RegEx("\r\n") | RegEx('\r')).Compiled();
   return e;
 }
 inline const RegEx& BlankOrBreak() {
-  static const RegEx e = Blank() | Break();
+  static const RegEx e = (Blank() | Break()).Compiled();
   return e;
 }
 inline const RegEx& Digit() {
-  static const RegEx e = RegEx('0', '9');
+  static const RegEx e = RegEx('0', '9').Compiled();
   return e;
 }
 inline const RegEx& Alpha() {
-  static const RegEx e = RegEx('a', 'z') | RegEx('A', 'Z');
+  static const RegEx e = (RegEx('a', 'z') | RegEx('A', 'Z')).Compiled();
   return e;
 }
 inline const RegEx& AlphaNumeric() {
-  static const RegEx e = Alpha() | Digit();
+  static const RegEx e = (Alpha() | Digit()).Compiled();
   return e;
 }
 inline const RegEx& Word() {
-  static const RegEx e = AlphaNumeric() | RegEx('-');
+  static const RegEx e = (AlphaNumeric() | RegEx('-')).Compiled();
   return e;
 }
 inline const RegEx& Hex() {
-  static const RegEx e = Digit() | RegEx('A', 'F') | RegEx('a', 'f');
+  static const RegEx e =
+      (Digit() | RegEx('A', 'F') | RegEx('a', 'f')).Compiled();
   return e;
 }
 // Valid Unicode code points that are not part of c-printable (YAML 1.2, sec.
 // 5.1)
 inline const RegEx& NotPrintable() {
   static const RegEx e =
-      RegEx(0) |
-      RegEx("\x01\x02\x03\x04\x05\x06\x07\x08\x0B\x0C\x7F", REGEX_OR) |
-      RegEx(0x0E, 0x1F) |
-      (RegEx('\xC2') + (RegEx('\x80', '\x84') | RegEx('\x86', '\x9F')));
+      (RegEx(0) |
+       RegEx("\x01\x02\x03\x04\x05\x06\x07\x08\x0B\x0C\x7F", REGEX_OR) |
+       RegEx(0x0E, 0x1F) |
+       (RegEx('\xC2') + (RegEx('\x80', '\x84') | RegEx('\x86', '\x9F'))))
+          .Compiled();
   return e;
 }
 inline const RegEx& Utf8_ByteOrderMark() {
-  static const RegEx e = RegEx("\xEF\xBB\xBF");
+  static const RegEx e = RegEx("\xEF\xBB\xBF").Compiled();
   return e;
 }
 
 // actual tags
 
 inline const RegEx& DocStart() {
-  static const RegEx e = RegEx("---") + (BlankOrBreak() | RegEx());
+  static const RegEx e = (RegEx("---") + (BlankOrBreak() | RegEx())).Compiled();
   return e;
 }
 inline const RegEx& DocEnd() {
-  static const RegEx e = RegEx("...") + (BlankOrBreak() | RegEx());
+  static const RegEx e = (RegEx("...") + (BlankOrBreak() | RegEx())).Compiled();
   return e;
 }
 inline const RegEx& DocIndicator() {
-  static const RegEx e = DocStart() | DocEnd();
+  static const RegEx e = (DocStart() | DocEnd()).Compiled();
   return e;
 }
 inline const RegEx& BlockEntry() {
-  static const RegEx e = RegEx('-') + (BlankOrBreak() | RegEx());
+  static const RegEx e = (RegEx('-') + (BlankOrBreak() | RegEx())).Compiled();
   return e;
 }
 inline const RegEx& Key() {
-  static const RegEx e = RegEx('?') + BlankOrBreak();
+  static const RegEx e = (RegEx('?') + BlankOrBreak()).Compiled();
   return e;
 }
 inline const RegEx& KeyInFlow() {
-  static const RegEx e = RegEx('?') + BlankOrBreak();
+  static const RegEx e = (RegEx('?') + BlankOrBreak()).Compiled();
   return e;
 }
 inline const RegEx& Value() {
-  static const RegEx e = RegEx(':') + (BlankOrBreak() | RegEx());
+  static const RegEx e = (RegEx(':') + (BlankOrBreak() | RegEx())).Compiled();
   return e;
 }
 inline const RegEx& ValueInFlow() {
-  static const RegEx e = RegEx(':') + (BlankOrBreak() | RegEx(",]}", REGEX_OR));
+  static const RegEx e =
+      (RegEx(':') + (BlankOrBreak() | RegEx(",]}", REGEX_OR))).Compiled();
   return e;
 }
 inline const RegEx& ValueInJSONFlow() {
-  static const RegEx e = RegEx(':');
+  static const RegEx e = RegEx(':').Compiled();
   return e;
 }
 inline const RegEx& Ampersand() {
-  static const RegEx e = RegEx('&');
+  static const RegEx e = RegEx('&').Compiled();
   return e;
 }
 inline const RegEx Comment() {
-  static const RegEx e = RegEx('#');
+  static const RegEx e = RegEx('#').Compiled();
   return e;
 }
 inline const RegEx& Anchor() {
-  static const RegEx e = !(RegEx("[]{},", REGEX_OR) | BlankOrBreak());
+  static const RegEx e =
+      (!(RegEx("[]{},", REGEX_OR) | BlankOrBreak())).Compiled();
   return e;
 }
 inline const RegEx& AnchorEnd() {
-  static const RegEx e = RegEx("?:,]}%@`", REGEX_OR) | BlankOrBreak();
+  static const RegEx e =
+      (RegEx("?:,]}%@`", REGEX_OR) | BlankOrBreak()).Compiled();
   return e;
 }
 inline const RegEx& URI() {
-  static const RegEx e = Word() | RegEx("#;/?:@&=+$,_.!~*'()[]", REGEX_OR) |
-                         (RegEx('%') + Hex() + Hex());
+  static const RegEx e = (Word() | RegEx("#;/?:@&=+$,_.!~*'()[]", REGEX_OR) |
+                          (RegEx('%') + Hex() + Hex()))
+                             .Compiled();
   return e;
 }
 inline const RegEx& Tag() {
-  static const RegEx e = Word() | RegEx("#;/?:@&=+$_.~*'()", REGEX_OR) |
-                         (RegEx('%') + Hex() + Hex());
+  static const RegEx e = (Word() | RegEx("#;/?:@&=+$_.~*'()", REGEX_OR) |
+                          (RegEx('%') + Hex() + Hex()))
+                             .Compiled();
   return e;
 }
 
@@ -152,53 +160,67 @@ inline const RegEx& Tag() {
 // space.
 inline const RegEx& PlainScalar() {
   static const RegEx e =
-      !(BlankOrBreak() | RegEx(",[]{}#&*!|>\'\"%@`", REGEX_OR) |
-        (RegEx("-?:", REGEX_OR) + (BlankOrBreak() | RegEx())));
+      (!(BlankOrBreak() | RegEx(",[]{}#&*!|>\'\"%@`", REGEX_OR) |
+         (RegEx("-?:", REGEX_OR) + (BlankOrBreak() | RegEx()))))
+          .Compiled();
   return e;
 }
 inline const RegEx& PlainScalarInFlow() {
   static const RegEx e =
-      !(BlankOrBreak() | RegEx("?,[]{}#&*!|>\'\"%@`", REGEX_OR) |
-        (RegEx("-:", REGEX_OR) + (Blank() | RegEx())));
+      (!(BlankOrBreak() | RegEx("?,[]{}#&*!|>\'\"%@`", REGEX_OR) |
+         (RegEx("-:", REGEX_OR) + (Blank() | RegEx()))))
+          .Compiled();
   return e;
 }
 inline const RegEx& EndScalar() {
-  static const RegEx e = RegEx(':') + (BlankOrBreak() | RegEx());
+  static const RegEx e = (RegEx(':') + (BlankOrBreak() | RegEx())).Compiled();
   return e;
 }
 inline const RegEx& EndScalarInFlow() {
   static const RegEx e =
-      (RegEx(':') + (BlankOrBreak() | RegEx() | RegEx(",]}", REGEX_OR))) |
-      RegEx(",?[]{}", REGEX_OR);
+      ((RegEx(':') + (BlankOrBreak() | RegEx() | RegEx(",]}", REGEX_OR))) |
+       RegEx(",?[]{}", REGEX_OR))
+          .Compiled();
   return e;
 }
 
 inline const RegEx& ScanScalarEndInFlow() {
-  static const RegEx e = (EndScalarInFlow() | (BlankOrBreak() + Comment()));
+  static const RegEx e =
+      (EndScalarInFlow() | (BlankOrBreak() + Comment())).Compiled();
   return e;
 }
 
 inline const RegEx& ScanScalarEnd() {
-  static const RegEx e = EndScalar() | (BlankOrBreak() + Comment());
+  static const RegEx e =
+      (EndScalar() | (BlankOrBreak() + Comment())).Compiled();
   return e;
 }
 inline const RegEx& EscSingleQuote() {
-  static const RegEx e = RegEx("\'\'");
+  static const RegEx e = RegEx("\'\'").Compiled();
+  return e;
+}
+inline const RegEx& EndSingleQuoted() {
+  static const RegEx e = (RegEx('\'') & !EscSingleQuote()).Compiled();
+  return e;
+}
+inline const RegEx& EndDoubleQuoted() {
+  static const RegEx e = RegEx('\"').Compiled();
   return e;
 }
 inline const RegEx& EscBreak() {
-  static const RegEx e = RegEx('\\') + Break();
+  static const RegEx e = (RegEx('\\') + Break()).Compiled();
   return e;
 }
 
 inline const RegEx& ChompIndicator() {
-  static const RegEx e = RegEx("+-", REGEX_OR);
+  static const RegEx e = RegEx("+-", REGEX_OR).Compiled();
   return e;
 }
 inline const RegEx& Chomp() {
-  static const RegEx e = (ChompIndicator() + Digit()) |
-                         (Digit() + ChompIndicator()) | ChompIndicator() |
-                         Digit();
+  static const RegEx e = ((ChompIndicator() + Digit()) |
+                          (Digit() + ChompIndicator()) | ChompIndicator() |
+                          Digit())
+                             .Compiled();
   return e;
 }
 
@@ -0,0 +1,358 @@
+#include "yaml-cpp/node/frozen.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+
+namespace YAML {
+namespace detail {
+struct frozen_document {
+  struct entry {
+    entry()
+        : mark{},
+          type(NodeType::Undefined),
+          style(EmitterStyle::Default),
+          tag(0),
+          scalar(0),
+          scalarSize(0),
+          items(0),
+          size(0),
+          keys(0) {}
+
+    Mark mark;
+    NodeType::value type;
+    EmitterStyle::value style;
+    std::uint32_t tag;  // in tags
+    std::size_t scalar;  // in scalars
+    std::size_t scalarSize;
+
+    // in items: a sequence's items, or a map's keys and values in pairs and
+    // then (the first item of) each pair with a scalar key, sorted by key
+    std::uint32_t items;
+    std::uint32_t size;
+    std::uint32_t keys;
+  };
+
+  frozen_document() : entries{}, items{}, tags{}, scalars{} {}
+
+  StringRef scalar(const entry& e) const {
+    return StringRef(scalars.data() + e.scalar, e.scalarSize);
+  }
+
+  std::vector<entry> entries;
+  std::vector<std::uint32_t> items;
+  std::vector<std::string> tags;
+  std::string scalars;
+};
+}  // namespace detail
+
+namespace {
+using detail::frozen_document;
+using Entry = frozen_document::entry;
+
+bool KeyLess(StringRef lhs, StringRef rhs) {
+  const int result =
+      std::memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+  return result < 0 || (result == 0 && lhs.size() < rhs.size());
+}
+
+// Copies a tree into a document, each node once.
+class Freezer {
+ public:
+  explicit Freezer(frozen_document& document)
+      : m_document(document), m_indices{}, m_tags{} {}
+  Freezer(const Freezer&) = delete;
+  Freezer& operator=(const Freezer&) = delete;
+
+  std::uint32_t Add(const detail::node& node) {
+    const auto found = m_indices.find(&node);
+    if (found != m_indices.end())
+      return found->second;
+
+    const auto index = static_cast<std::uint32_t>(m_document.entries.size());
+    m_indices.emplace(&node, index);
+    m_document.entries.emplace_back();
+    {
+      Entry& entry = m_document.entries.back();
+      entry.mark = node.mark();
+      entry.type = node.type();
+      entry.style = node.style();
+      entry.tag = AddTag(node.tag());
+      entry.scalar = m_document.scalars.size();
+      entry.scalarSize = node.scalar().size();
+      m_document.scalars += node.scalar();
+    }
+
+    std::vector<std::uint32_t> items;
+    std::uint32_t keys = 0;
+    if (node.type() == NodeType::Sequence) {
+      for (auto it = node.begin(); it != node.end(); ++it) {
+        if (it->pNode && it->pNode->is_defined())
+          items.push_back(Add(*it->pNode));
+      }
+    } else if (node.type() == NodeType::Map) {
+      std::vector<std::uint32_t> sorted;
+      for (auto it = node.begin(); it != node.end(); ++it) {
+        if (!it->first || !it->first->is_defined() ||
+            !it->second->is_defined())
+          continue;
+        if (it->first->type() == NodeType::Scalar)
+          sorted.push_back(static_cast<std::uint32_t>(items.size()));
+        items.push_back(Add(*it->first));
+        items.push_back(Add(*it->second));
+      }
+
+      // (stably, so the first of equal keys is found, as with a Node)
+      const frozen_document& document = m_document;
+      std::stable_sort(sorted.begin(), sorted.end(),
+                       [&](std::uint32_t lhs, std::uint32_t rhs) {
+                         return KeyLess(
+                             document.scalar(document.entries[items[lhs]]),
+                             document.scalar(document.entries[items[rhs]]));
+                       });
+      keys = static_cast<std::uint32_t>(sorted.size());
+      items.insert(items.end(), sorted.begin(), sorted.end());
+    }
+
+    Entry& entry = m_document.entries[index];
+    entry.items = static_cast<std::uint32_t>(m_document.items.size());
+    entry.size = static_cast<std::uint32_t>(items.size() - keys);
+    if (entry.type == NodeType::Map)
+      entry.size /= 2;
+    entry.keys = keys;
+    m_document.items.insert(m_document.items.end(), items.begin(),
+                            items.end());
+    return index;
+  }
+
+ private:
+  std::uint32_t AddTag(const std::string& tag) {
+    const auto found = m_tags.find(tag);
+    if (found != m_tags.end())
+      return found->second;
+
+    const auto index = static_cast<std::uint32_t>(m_document.tags.size());
+    m_document.tags.push_back(tag);
+    m_tags.emplace(tag, index);
+    return index;
+  }
+
+  frozen_document& m_document;
+  std::unordered_map<const detail::node*, std::uint32_t> m_indices;
+  std::unordered_map<std::string, std::uint32_t> m_tags;
+};
+
+// Copies (part of) a document back into a tree, each entry once.
+class Thawer {
+ public:
+  explicit Thawer(const frozen_document& document)
+      : m_document(document),
+        m_pMemory(std::make_shared<detail::memory_holder>()),
+        m_nodes(document.entries.size(), nullptr) {}
+  Thawer(const Thawer&) = delete;
+  Thawer& operator=(const Thawer&) = delete;
+
+  const detail::shared_memory_holder& memory() const { return m_pMemory; }
+
+  detail::node& Add(std::uint32_t index) {
+    if (m_nodes[index])
+      return *m_nodes[index];
+
+    const Entry& entry = m_document.entries[index];
+    detail::node& node = m_pMemory->create_node();
+    m_nodes[index] = &node;
+    node.set_mark(entry.mark);
+
+    const std::uint32_t* items = m_document.items.data() + entry.items;
+    switch (entry.type) {
+      case NodeType::Undefined:
+        return node;
+      case NodeType::Null:
+        node.set_null();
+        break;
+      case NodeType::Scalar:
+        node.set_scalar(m_document.scalar(entry).str());
+        break;
+      case NodeType::Sequence:
+        node.set_type(NodeType::Sequence);
+        for (std::uint32_t i = 0; i < entry.size; i++)
+          node.push_back(Add(items[i]), m_pMemory);
+        break;
+      case NodeType::Map:
+        node.set_type(NodeType::Map);
+        for (std::uint32_t i = 0; i < entry.size; i++)
+          node.insert(Add(items[2 * i]), Add(items[2 * i + 1]), m_pMemory);
+        break;
+    }
+    node.set_tag(m_document.tags[entry.tag]);
+    node.set_style(entry.style);
+    return node;
+  }
+
+ private:
+  const frozen_document& m_document;
+  detail::shared_memory_holder m_pMemory;
+  std::vector<detail::node*> m_nodes;
+};
+}  // namespace
+
+FrozenNode::FrozenNode(const Node& node)
+    : m_pDocument{}, m_index(0), m_isValid(true) {
+  if (!node.m_isValid)
+    throw InvalidNode(node.m_invalidKey);
+  if (!node.m_pNode)
+    return;
+
+  std::shared_ptr<frozen_document> pDocument =
+      std::make_shared<frozen_document>();
+  Freezer(*pDocument).Add(*node.m_pNode);
+  pDocument->entries.shrink_to_fit();
+  pDocument->items.shrink_to_fit();
+  pDocument->scalars.shrink_to_fit();
+  m_pDocument = std::move(pDocument);
+}
+
+FrozenNode Freeze(const Node& node) { return FrozenNode(node); }
+
+FrozenNode FrozenNode::Missing() {
+  FrozenNode node;
+  node.m_isValid = false;
+  return node;
+}
+
+Mark FrozenNode::Mark() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->entries[m_index].mark : Mark::null_mark();
+}
+
+NodeType::value FrozenNode::Type() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->entries[m_index].type : NodeType::Null;
+}
+
+bool FrozenNode::IsDefined() const {
+  if (!m_isValid)
+    return false;
+  return !m_pDocument ||
+         m_pDocument->entries[m_index].type != NodeType::Undefined;
+}
+
+StringRef FrozenNode::Scalar() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->scalar(m_pDocument->entries[m_index])
+                     : StringRef();
+}
+
+const std::string& FrozenNode::Tag() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->tags[m_pDocument->entries[m_index].tag]
+                     : detail::node_data::empty_scalar();
+}
+
+EmitterStyle::value FrozenNode::Style() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->entries[m_index].style
+                     : EmitterStyle::Default;
+}
+
+bool FrozenNode::is(const FrozenNode& rhs) const {
+  if (!m_isValid || !rhs.m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pDocument || !rhs.m_pDocument)
+    return false;
+  return m_pDocument == rhs.m_pDocument && m_index == rhs.m_index;
+}
+
+Node FrozenNode::Thaw() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pDocument)
+    return Node();
+
+  Thawer thawer(*m_pDocument);
+  return Node(thawer.Add(m_index), thawer.memory());
+}
+
+std::size_t FrozenNode::size() const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  return m_pDocument ? m_pDocument->entries[m_index].size : 0;
+}
+
+FrozenNode::const_iterator FrozenNode::begin() const {
+  if (!m_isValid || !m_pDocument)
+    return const_iterator();
+  return const_iterator(*this, 0);
+}
+
+FrozenNode::const_iterator FrozenNode::end() const {
+  if (!m_isValid || !m_pDocument)
+    return const_iterator();
+  const Entry& entry = m_pDocument->entries[m_index];
+  const bool items = entry.type == NodeType::Sequence ||
+                     entry.type == NodeType::Map;
+  return const_iterator(*this, items ? entry.size : 0);
+}
+
+FrozenNode FrozenNode::operator[](StringRef key) const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pDocument)
+    return Missing();
+
+  const frozen_document& document = *m_pDocument;
+  const Entry& entry = document.entries[m_index];
+  if (entry.type != NodeType::Map)
+    return Missing();
+
+  const std::uint32_t* items = document.items.data() + entry.items;
+  const std::uint32_t* sorted = items + 2 * entry.size;
+  const std::uint32_t* found = std::lower_bound(
+      sorted, sorted + entry.keys, key, [&](std::uint32_t item, StringRef k) {
+        return KeyLess(document.scalar(document.entries[items[item]]), k);
+      });
+  if (found == sorted + entry.keys ||
+      document.scalar(document.entries[items[*found]]) != key)
+    return Missing();
+  return FrozenNode(m_pDocument, items[*found + 1]);
+}
+
+FrozenNode FrozenNode::operator[](std::size_t index) const {
+  if (!m_isValid)
+    throw InvalidNode(std::string());
+  if (!m_pDocument)
+    return Missing();
+
+  const Entry& entry = m_pDocument->entries[m_index];
+  if (entry.type == NodeType::Map)
+    return (*this)[std::to_string(index)];
+  if (entry.type != NodeType::Sequence || index >= entry.size)
+    return Missing();
+  return FrozenNode(m_pDocument, m_pDocument->items[entry.items + index]);
+}
+
+FrozenNode::const_iterator::value_type FrozenNode::const_iterator::operator*()
+    const {
+  const frozen_document& document = *m_node.m_pDocument;
+  const Entry& entry = document.entries[m_node.m_index];
+  const std::uint32_t* items = document.items.data() + entry.items;
+  if (entry.type == NodeType::Sequence)
+    return value_type(FrozenNode(m_node.m_pDocument, items[m_item]),
+                      Missing(), Missing());
+  return value_type(Missing(),
+                    FrozenNode(m_node.m_pDocument, items[2 * m_item]),
+                    FrozenNode(m_node.m_pDocument, items[2 * m_item + 1]));
+}
+}  // namespace YAML
@@ -0,0 +1,52 @@
+#include "keyfilter.h"
+
+#include <algorithm>
+
+namespace YAML {
+namespace {
+using Child = std::pair<std::string, KeyFilter::State>;
+
+bool KeyLess(const Child& child, const StringRef& key) {
+  return child.first.compare(0, std::string::npos, key.data(), key.size()) <
+         0;
+}
+}  // namespace
+
+constexpr KeyFilter::State KeyFilter::All;
+
+KeyFilter::KeyFilter(const std::vector<std::vector<std::string>>& paths)
+    : m_nodes(1) {
+  for (const std::vector<std::string>& path : paths) {
+    State state = 0;
+    for (const std::string& key : path) {
+      std::vector<Child>& children = m_nodes[state].children;
+      auto it = std::lower_bound(children.begin(), children.end(),
+                                 StringRef(key), KeyLess);
+      if (it == children.end() || it->first != key) {
+        it = children.emplace(it, key, m_nodes.size());
+        state = it->second;
+        m_nodes.emplace_back();  // (which may move the children above)
+      } else {
+        state = it->second;
+      }
+    }
+    m_nodes[state].whole = true;
+  }
+}
+
+bool KeyFilter::Find(State state, StringRef key, State& next) const {
+  if (state == All) {
+    next = All;
+    return true;
+  }
+
+  const std::vector<Child>& children = m_nodes[state].children;
+  const auto it =
+      std::lower_bound(children.begin(), children.end(), key, KeyLess);
+  if (it == children.end() || StringRef(it->first) != key)
+    return false;
+
+  next = m_nodes[it->second].whole ? All : it->second;
+  return true;
+}
+}  // namespace YAML
@@ -0,0 +1,53 @@
+#ifndef KEYFILTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define KEYFILTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+/**
+ * The key paths that a selective parse keeps, as a tree of their keys.
+ *
+ * The parser walks it with a state for each collection: the node of the tree
+ * that the keys of a map are looked up in, or {@code All} once everything
+ * below is kept.
+ */
+class KeyFilter {
+ public:
+  using State = std::size_t;
+  static constexpr State All = static_cast<State>(-1);
+
+  explicit KeyFilter(const std::vector<std::vector<std::string>>& paths);
+
+  /** Returns the state of the document itself. */
+  State root() const { return m_nodes[0].whole ? All : 0; }
+
+  /**
+   * Returns true if the value of the given key is kept, in a map in the given
+   * state, and sets {@code next} to the state of that value.
+   */
+  bool Find(State state, StringRef key, State& next) const;
+
+ private:
+  struct Node {
+    Node() : whole(false), children{} {}
+
+    bool whole;  // a path ends here
+    std::vector<std::pair<std::string, State>> children;  // sorted by key
+  };
+
+  std::vector<Node> m_nodes;  // the root first
+};
+}  // namespace YAML
+
+#endif  // KEYFILTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
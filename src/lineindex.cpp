@@ -0,0 +1,59 @@
+#include "yaml-cpp/lineindex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace YAML {
+namespace {
+// The same choice that the stream makes as it goes: the first line ending
+// decides whether lines end with '\n' (for "\n" or "\r\n") or with '\r'.
+char FindLineEnding(const char* data, std::size_t size) {
+  const void* lf = std::memchr(data, '\n', size);
+  const std::size_t n =
+      lf ? static_cast<std::size_t>(static_cast<const char*>(lf) - data)
+         : size;
+  const void* cr = std::memchr(data, '\r', n);
+  if (!cr)
+    return '\n';
+
+  const char* next = static_cast<const char*>(cr) + 1;
+  return next < data + size && *next == '\n' ? '\n' : '\r';
+}
+}  // namespace
+
+LineIndex::LineIndex(const char* data, std::size_t size)
+    : m_pData(data), m_size(size), m_lineEnding('\n'), m_lineStarts{} {
+  // offsets are counted after the byte order mark, as the stream skips it
+  if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+    m_pData += 3;
+    m_size -= 3;
+  }
+  m_lineEnding = FindLineEnding(m_pData, m_size);
+}
+
+Mark LineIndex::Locate(const Mark& mark) const {
+  if (mark.pos < 0 || mark.line >= 0)
+    return mark;
+
+  if (m_lineStarts.empty()) {
+    m_lineStarts.push_back(0);
+    const char* const end = m_pData + m_size;
+    for (const char* p = m_pData;; p++) {
+      p = static_cast<const char*>(
+          std::memchr(p, m_lineEnding, static_cast<std::size_t>(end - p)));
+      if (!p)
+        break;
+      m_lineStarts.push_back(static_cast<std::size_t>(p + 1 - m_pData));
+    }
+  }
+
+  const std::size_t pos = static_cast<std::size_t>(mark.pos);
+  const auto lineStart =
+      std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), pos) - 1;
+
+  Mark located = mark;
+  located.line = static_cast<int>(lineStart - m_lineStarts.begin());
+  located.column = static_cast<int>(pos - *lineStart);
+  return located;
+}
+}  // namespace YAML
@@ -0,0 +1,135 @@
+#include "mappedfile.h"
+
+#include <limits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace YAML {
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : m_pData(nullptr),
+      m_size(0),
+      m_hFile(INVALID_HANDLE_VALUE),
+      m_hMapping(nullptr) {}
+#else
+MappedFile::MappedFile() : m_pData(nullptr), m_size(0) {}
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& filename) {
+  Close();
+
+  m_hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                        nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                        nullptr);
+  if (m_hFile == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (GetFileType(m_hFile) != FILE_TYPE_DISK || !GetFileSizeEx(m_hFile, &size) ||
+      static_cast<unsigned long long>(size.QuadPart) >
+          std::numeric_limits<std::size_t>::max()) {
+    Close();
+    return false;
+  }
+
+  // an empty file can't be mapped, but there's nothing to read anyways
+  m_size = static_cast<std::size_t>(size.QuadPart);
+  if (m_size == 0) {
+    return true;
+  }
+
+  m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_hMapping) {
+    Close();
+    return false;
+  }
+
+  m_pData = static_cast<const char*>(
+      MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_pData) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_pData) {
+    UnmapViewOfFile(m_pData);
+  }
+  if (m_hMapping) {
+    CloseHandle(m_hMapping);
+  }
+  if (m_hFile != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_hFile);
+  }
+  m_pData = nullptr;
+  m_size = 0;
+  m_hFile = INVALID_HANDLE_VALUE;
+  m_hMapping = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& filename) {
+  Close();
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+      static_cast<unsigned long long>(info.st_size) >
+          std::numeric_limits<std::size_t>::max()) {
+    close(fd);
+    return false;
+  }
+
+  // an empty file can't be mapped, but there's nothing to read anyways
+  std::size_t size = static_cast<std::size_t>(info.st_size);
+  if (size == 0) {
+    close(fd);
+    return true;
+  }
+
+  void* pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (pData == MAP_FAILED) {
+    return false;
+  }
+
+#ifdef MADV_SEQUENTIAL
+  madvise(pData, size, MADV_SEQUENTIAL);
+#endif
+
+  m_pData = static_cast<const char*>(pData);
+  m_size = size;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_pData) {
+    munmap(const_cast<char*>(m_pData), m_size);
+  }
+  m_pData = nullptr;
+  m_size = 0;
+}
+#endif
+}  // namespace YAML
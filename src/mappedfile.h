@@ -0,0 +1,51 @@
+#ifndef MAPPEDFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define MAPPEDFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace YAML {
+/**
+ * A read-only memory mapping of a whole regular file.
+ *
+ * Note: as with any mapping, the file must not be truncated while it is
+ * mapped.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+  ~MappedFile();
+
+  /**
+   * Maps the given file. Returns false if it isn't a regular file or can't be
+   * mapped, in which case it should be read as a stream instead.
+   */
+  bool Open(const std::string& filename);
+
+  const char* data() const { return m_pData; }
+  std::size_t size() const { return m_size; }
+
+ private:
+  void Close();
+
+ private:
+  const char* m_pData;
+  std::size_t m_size;
+#ifdef _WIN32
+  void* m_hFile;
+  void* m_hMapping;
+#endif
+};
+}  // namespace YAML
+
+#endif  // MAPPEDFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,34 +1,199 @@
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <string>
+
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/ptr.h"
 
 namespace YAML {
 namespace detail {
+namespace {
+const std::size_t kAlignment = alignof(std::max_align_t);
+
+std::size_t AlignUp(std::size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+}  // namespace
+
+const std::size_t arena::kFirstBlockSize;
+const std::size_t arena::kMaxBlockSize;
+
+struct arena::block {
+  block* pNext;
+};
+
+// A node, along with the ref and the data that it starts out with: all in one
+// allocation, which (like everything else in the arena) lasts until the arena
+// does, even once the node refers to some other ref or data.
+struct arena::node_entry {
+  explicit node_entry(node_entry* pNext_)
+      : pNext(pNext_), data(), ref(data), value(ref) {}
+  node_entry(const node_entry&) = delete;
+  node_entry& operator=(const node_entry&) = delete;
+
+  node_entry* pNext;
+  node_data data;
+  node_ref ref;
+  node value;
+};
+
+const std::size_t arena::kStringsPerBlock;
+
+// Room for some strings (say, scalars that nodes share), which follow it, and
+// are made one at a time.
+struct arena::string_block {
+  std::string* strings() { return reinterpret_cast<std::string*>(this + 1); }
+
+  string_block* pNext;
+  std::size_t size;
+};
+
+arena::~arena() {
+  // the nodes may share each other's data, so destroy them all before freeing
+  // any of the memory
+  for (node_entry* pEntry = m_pNodes; pEntry;) {
+    node_entry* pNext = pEntry->pNext;
+    pEntry->~node_entry();
+    pEntry = pNext;
+  }
+  for (string_block* pStrings = m_pStrings; pStrings;) {
+    string_block* pNext = pStrings->pNext;
+    for (std::size_t i = 0; i < pStrings->size; i++) {
+      using std::string;
+      pStrings->strings()[i].~string();
+    }
+    pStrings = pNext;
+  }
+
+  for (block* pBlock = m_pBlocks; pBlock;) {
+    block* pNext = pBlock->pNext;
+    ::operator delete(pBlock);
+    pBlock = pNext;
+  }
+}
+
+void* arena::allocate(std::size_t size) {
+  size = AlignUp(size);
+  if (static_cast<std::size_t>(m_pEnd - m_pCur) < size) {
+    const std::size_t header = AlignUp(sizeof(block));
+    const std::size_t blockSize = std::max(m_nextBlockSize, header + size);
+    m_nextBlockSize = std::min(m_nextBlockSize * 2, kMaxBlockSize);
+
+    block* pBlock = static_cast<block*>(::operator new(blockSize));
+    pBlock->pNext = m_pBlocks;
+    if (!m_pBlocks)
+      m_pLastBlock = pBlock;
+    m_pBlocks = pBlock;
+
+    m_pCur = reinterpret_cast<char*>(pBlock) + header;
+    m_pEnd = reinterpret_cast<char*>(pBlock) + blockSize;
+  }
+
+  void* pResult = m_pCur;
+  m_pCur += size;
+  return pResult;
+}
+
+node& arena::create_node() {
+  void* pMemory = allocate(sizeof(node_entry));
+  node_entry* pEntry = new (pMemory) node_entry(m_pNodes);
+  if (!m_pNodes)
+    m_pLastNode = pEntry;
+  m_pNodes = pEntry;
+  m_size++;
+  return pEntry->value;
+}
+
+const std::string& arena::create_string(const std::string& value) {
+  if (!m_pStrings || m_pStrings->size == kStringsPerBlock) {
+    static_assert(sizeof(string_block) % alignof(std::string) == 0,
+                  "the strings must be aligned");
+    void* pMemory = allocate(sizeof(string_block) +
+                             kStringsPerBlock * sizeof(std::string));
+    string_block* pStrings = static_cast<string_block*>(pMemory);
+    pStrings->pNext = m_pStrings;
+    pStrings->size = 0;
+    if (!m_pStrings)
+      m_pLastStrings = pStrings;
+    m_pStrings = pStrings;
+  }
+
+  std::string* pString = new (&m_pStrings->strings()[m_pStrings->size])
+      std::string(value);
+  m_pStrings->size++;
+  return *pString;
+}
+
+void arena::splice(arena& rhs) {
+  if (rhs.m_pBlocks) {
+    rhs.m_pLastBlock->pNext = m_pBlocks;
+    if (!m_pBlocks)
+      m_pLastBlock = rhs.m_pLastBlock;
+    m_pBlocks = rhs.m_pBlocks;
+  }
+
+  if (rhs.m_pNodes) {
+    rhs.m_pLastNode->pNext = m_pNodes;
+    if (!m_pNodes)
+      m_pLastNode = rhs.m_pLastNode;
+    m_pNodes = rhs.m_pNodes;
+  }
+
+  // (after ours, so that ours is still the one being filled)
+  if (rhs.m_pStrings) {
+    if (m_pStrings)
+      m_pLastStrings->pNext = rhs.m_pStrings;
+    else
+      m_pStrings = rhs.m_pStrings;
+    m_pLastStrings = rhs.m_pLastStrings;
+  }
+
+  m_size += rhs.m_size;
+
+  rhs.m_pBlocks = rhs.m_pLastBlock = nullptr;
+  rhs.m_pCur = rhs.m_pEnd = nullptr;
+  rhs.m_pNodes = rhs.m_pLastNode = nullptr;
+  rhs.m_pStrings = rhs.m_pLastStrings = nullptr;
+  rhs.m_size = 0;
+}
 
 void memory_holder::merge(memory_holder& rhs) {
-  if (m_pMemory == rhs.m_pMemory)
+  memory& lhsMemory = get();
+  memory& rhsMemory = rhs.get();
+  if (&lhsMemory == &rhsMemory)
     return;
 
-  if (m_pMemory->size() < rhs.m_pMemory->size()) {
+  if (lhsMemory.size() < rhsMemory.size()) {
     std::swap(m_pMemory, rhs.m_pMemory);
   }
 
   m_pMemory->merge(*rhs.m_pMemory);
+  rhs.m_pMemory->m_pMergedInto = m_pMemory;
   rhs.m_pMemory = m_pMemory;
 }
 
-node& memory::create_node() {
-  shared_node pNode(std::make_shared<node>());
-  m_nodes.insert(pNode);
-  return *pNode;
+node& memory::create_node() { return m_arena.create_node(); }
+
+const std::string& memory::store_string(const std::string& value) {
+  return m_arena.create_string(value);
 }
 
-void memory::merge(const memory& rhs) {
-  m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
+void memory::merge(memory& rhs) {
+  m_arena.splice(rhs.m_arena);
+
+  // carry on past both sequences, so that what comes next is still ordered
+  // after everything before
+  m_sequence = std::max(m_sequence, rhs.m_sequence);
+
+  // Likewise, an index that was built in either memory is behind this count
+  // if one of its keys has changed since, and no further.
+  m_keyChanges = std::max(m_keyChanges, rhs.m_keyChanges);
 }
 
 size_t memory::size() const {
-    return m_nodes.size();
+    return m_arena.size();
 }
 }  // namespace detail
 }  // namespace YAML
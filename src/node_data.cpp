@@ -1,7 +1,10 @@
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <sstream>
+#include <unordered_map>
 
 #include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
@@ -13,24 +16,70 @@
 
 namespace YAML {
 namespace detail {
-YAML_CPP_API std::atomic<size_t> node::m_amount{0};
+namespace {
+// maps with fewer pairs than this are just searched
+const std::size_t kKeyIndexThreshold = 32;
+
+// FNV-1a
+std::size_t hash_scalar(const char* data, std::size_t size) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+bool is_scalar_key(const node& key, const char* data, std::size_t size) {
+  // (equal interned scalars share one string, so that's quicker to check)
+  return key.type() == NodeType::Scalar && key.scalar().size() == size &&
+         (key.scalar().data() == data ||
+          std::memcmp(key.scalar().data(), data, size) == 0);
+}
+}  // namespace
+
+// An index on the scalars of the map's keys, as they were when indexed; the
+// keys that weren't scalars then (say, an undefined node that's assigned later)
+// are just listed.
+struct node_data::key_index {
+  key_index() : byScalar{}, others{}, keyChanges(0) {}
+
+  std::unordered_multimap<std::size_t, kv_pair> byScalar;
+  std::vector<kv_pair> others;
+  std::size_t keyChanges;  // the memory's count, as of when it was built
+};
 
 const std::string& node_data::empty_scalar() {
   static const std::string svalue;
   return svalue;
 }
 
+node_data::collection::collection()
+    : sequence{}, seqSize(0), map{}, undefinedPairs{}, pKeyIndex{} {}
+
+node_data::collection::~collection() = default;
+
 node_data::node_data()
-    : m_isDefined(false),
-      m_mark(Mark::null_mark()),
+    : m_mark(Mark::null_mark()),
       m_type(NodeType::Null),
-      m_tag{},
       m_style(EmitterStyle::Default),
-      m_scalar{},
-      m_sequence{},
-      m_seqSize(0),
-      m_map{},
-      m_undefinedPairs{} {}
+      m_isDefined(false),
+      m_tagKind(NoTag),
+      m_ownsScalar(false),
+      m_isIndexedKey(false),
+      m_pTag{},
+      m_pScalar(&empty_scalar()),
+      m_pCollection{} {}
+
+node_data::~node_data() {
+  if (m_ownsScalar)
+    delete m_pScalar;
+}
+
+const std::string& node_data::tag() const {
+  static const std::string tags[] = {"", "?", "!"};
+  return m_tagKind == OtherTag ? *m_pTag : tags[m_tagKind];
+}
 
 void node_data::mark_defined() {
   if (m_type == NodeType::Undefined)
@@ -57,7 +106,7 @@ void node_data::set_type(NodeType::value type) {
     case NodeType::Null:
       break;
     case NodeType::Scalar:
-      m_scalar.clear();
+      set_shared_scalar(empty_scalar());
       break;
     case NodeType::Sequence:
       reset_sequence();
@@ -71,7 +120,18 @@ void node_data::set_type(NodeType::value type) {
   }
 }
 
-void node_data::set_tag(const std::string& tag) { m_tag = tag; }
+void node_data::set_tag(const std::string& tag) {
+  if (tag.empty() || tag == "?" || tag == "!") {
+    m_tagKind = tag.empty() ? NoTag : tag[0] == '?' ? PlainTag : NonPlainTag;
+    m_pTag.reset();
+  } else if (m_pTag) {
+    m_tagKind = OtherTag;
+    *m_pTag = tag;
+  } else {
+    m_tagKind = OtherTag;
+    m_pTag.reset(new std::string(tag));
+  }
+}
 
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
@@ -83,7 +143,22 @@ void node_data::set_null() {
 void node_data::set_scalar(const std::string& scalar) {
   m_isDefined = true;
   m_type = NodeType::Scalar;
-  m_scalar = scalar;
+  if (m_ownsScalar) {
+    *const_cast<std::string*>(m_pScalar) = scalar;
+  } else {
+    m_pScalar = new std::string(scalar);
+    m_ownsScalar = true;
+  }
+}
+
+void node_data::set_shared_scalar(const std::string& scalar) {
+  m_isDefined = true;
+  m_type = NodeType::Scalar;
+  if (m_ownsScalar) {
+    delete m_pScalar;
+    m_ownsScalar = false;
+  }
+  m_pScalar = &scalar;
 }
 
 // size/iterator
@@ -94,10 +169,11 @@ std::size_t node_data::size() const {
   switch (m_type) {
     case NodeType::Sequence:
       compute_seq_size();
-      return m_seqSize;
+      return m_pCollection->seqSize;
     case NodeType::Map:
       compute_map_size();
-      return m_map.size() - m_undefinedPairs.size();
+      return m_pCollection->map.size() -
+             m_pCollection->undefinedPairs.size();
     default:
       return 0;
   }
@@ -105,16 +181,19 @@ std::size_t node_data::size() const {
 }
 
 void node_data::compute_seq_size() const {
-  while (m_seqSize < m_sequence.size() && m_sequence[m_seqSize]->is_defined())
-    m_seqSize++;
+  const collection& items = *m_pCollection;
+  while (items.seqSize < items.sequence.size() &&
+         items.sequence[items.seqSize]->is_defined())
+    items.seqSize++;
 }
 
 void node_data::compute_map_size() const {
-  auto it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
+  kv_pairs& undefinedPairs = m_pCollection->undefinedPairs;
+  auto it = undefinedPairs.begin();
+  while (it != undefinedPairs.end()) {
     auto jt = std::next(it);
     if (it->first->is_defined() && it->second->is_defined())
-      m_undefinedPairs.erase(it);
+      undefinedPairs.erase(it);
     it = jt;
   }
 }
@@ -125,9 +204,10 @@ const_node_iterator node_data::begin() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.begin());
+      return const_node_iterator(m_pCollection->sequence.begin());
     case NodeType::Map:
-      return const_node_iterator(m_map.begin(), m_map.end());
+      return const_node_iterator(m_pCollection->map.begin(),
+                                 m_pCollection->map.end());
     default:
       return {};
   }
@@ -139,9 +219,10 @@ node_iterator node_data::begin() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.begin());
+      return node_iterator(m_pCollection->sequence.begin());
     case NodeType::Map:
-      return node_iterator(m_map.begin(), m_map.end());
+      return node_iterator(m_pCollection->map.begin(),
+                           m_pCollection->map.end());
     default:
       return {};
   }
@@ -153,9 +234,10 @@ const_node_iterator node_data::end() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.end());
+      return const_node_iterator(m_pCollection->sequence.end());
     case NodeType::Map:
-      return const_node_iterator(m_map.end(), m_map.end());
+      return const_node_iterator(m_pCollection->map.end(),
+                                 m_pCollection->map.end());
     default:
       return {};
   }
@@ -167,9 +249,9 @@ node_iterator node_data::end() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.end());
+      return node_iterator(m_pCollection->sequence.end());
     case NodeType::Map:
-      return node_iterator(m_map.end(), m_map.end());
+      return node_iterator(m_pCollection->map.end(), m_pCollection->map.end());
     default:
       return {};
   }
@@ -186,7 +268,7 @@ void node_data::push_back(node& node,
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
-  m_sequence.push_back(&node);
+  m_pCollection->sequence.push_back(&node);
 }
 
 void node_data::insert(node& key, node& value,
@@ -203,7 +285,7 @@ void node_data::insert(node& key, node& value,
       throw BadSubscript(m_mark, key);
   }
 
-  insert_map_pair(key, value);
+  insert_map_pair(key, value, pMemory);
 }
 
 // indexing
@@ -213,7 +295,7 @@ node* node_data::get(node& key,
     return nullptr;
   }
 
-  for (const auto& it : m_map) {
+  for (const auto& it : m_pCollection->map) {
     if (it.first->is(key))
       return it.second;
   }
@@ -234,13 +316,13 @@ node& node_data::get(node& key, const shared_memory_holder& pMemory) {
       throw BadSubscript(m_mark, key);
   }
 
-  for (const auto& it : m_map) {
+  for (const auto& it : m_pCollection->map) {
     if (it.first->is(key))
       return *it.second;
   }
 
   node& value = pMemory->create_node();
-  insert_map_pair(key, value);
+  insert_map_pair(key, value, pMemory);
   return value;
 }
 
@@ -248,21 +330,24 @@ bool node_data::remove(node& key, const shared_memory_holder& /* pMemory */) {
   if (m_type != NodeType::Map)
     return false;
 
-  for (auto it = m_undefinedPairs.begin(); it != m_undefinedPairs.end();) {
+  collection& items = *m_pCollection;
+  for (auto it = items.undefinedPairs.begin();
+       it != items.undefinedPairs.end();) {
     auto jt = std::next(it);
     if (it->first->is(key))
-      m_undefinedPairs.erase(it);
+      items.undefinedPairs.erase(it);
     it = jt;
   }
 
   auto it =
-      std::find_if(m_map.begin(), m_map.end(),
+      std::find_if(items.map.begin(), items.map.end(),
                    [&](std::pair<YAML::detail::node*, YAML::detail::node*> j) {
                      return (j.first->is(key));
                    });
 
-  if (it != m_map.end()) {
-    m_map.erase(it);
+  if (it != items.map.end()) {
+    unindex_map_pair(*it);
+    items.map.erase(it);
     return true;
   }
 
@@ -270,25 +355,140 @@ bool node_data::remove(node& key, const shared_memory_holder& /* pMemory */) {
 }
 
 void node_data::reset_sequence() {
-  m_sequence.clear();
-  m_seqSize = 0;
+  collection& items = get_collection();
+  items.sequence.clear();
+  items.seqSize = 0;
 }
 
 void node_data::reset_map() {
-  m_map.clear();
-  m_undefinedPairs.clear();
+  collection& items = get_collection();
+  items.map.clear();
+  items.undefinedPairs.clear();
+  items.pKeyIndex.reset();
+}
+
+node_data::collection& node_data::get_collection() {
+  if (!m_pCollection)
+    m_pCollection.reset(new collection);
+  return *m_pCollection;
 }
 
-void node_data::insert_map_pair(node& key, node& value, bool force) {
-  if (!force && !key.scalar().empty())
-    for (const auto& mapEntry : m_map)
-      if (mapEntry.first->scalar() == key.scalar())
+void node_data::insert_map_pair(node& key, node& value,
+                                const shared_memory_holder& pMemory,
+                                bool force) {
+  refresh_key_index(pMemory);
+  collection& items = *m_pCollection;
+  if (!force && !key.scalar().empty()) {
+    const std::string& scalar = key.scalar();
+    kv_pair existing;
+    if (items.pKeyIndex && key.type() == NodeType::Scalar &&
+        find_scalar_key(scalar.data(), scalar.size(), existing, pMemory)) {
+      // the index only knows about scalar keys
+      if (existing.first)
         throw NonUniqueMapKey(m_mark, key);
+      for (const auto& other : items.pKeyIndex->others)
+        if (other.first->scalar() == scalar)
+          throw NonUniqueMapKey(m_mark, key);
+    } else {
+      for (const auto& mapEntry : items.map)
+        if (mapEntry.first->scalar() == scalar)
+          throw NonUniqueMapKey(m_mark, key);
+    }
+  }
 
-  m_map.emplace_back(&key, &value);
+  items.map.emplace_back(&key, &value);
 
   if (!key.is_defined() || !value.is_defined())
-    m_undefinedPairs.emplace_back(&key, &value);
+    items.undefinedPairs.emplace_back(&key, &value);
+
+  if (items.pKeyIndex)
+    index_map_pair(items.map.back());
+  else if (items.map.size() >= kKeyIndexThreshold)
+    build_key_index(pMemory);
+}
+
+bool node_data::find_scalar_key(const char* key, std::size_t size,
+                                kv_pair& pair,
+                                const shared_memory_holder& pMemory) const {
+  // (a const lookup doesn't rebuild an index that's out of date, so that
+  // readers don't write)
+  const key_index* pKeyIndex = m_pCollection->pKeyIndex.get();
+  if (!pKeyIndex || pKeyIndex->keyChanges != pMemory->key_changes())
+    return false;
+
+  pair = kv_pair(nullptr, nullptr);
+  const auto range = pKeyIndex->byScalar.equal_range(hash_scalar(key, size));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (is_scalar_key(*it->second.first, key, size)) {
+      if (pair.first)
+        return false;
+      pair = it->second;
+    }
+  }
+  for (const auto& other : pKeyIndex->others) {
+    if (is_scalar_key(*other.first, key, size)) {
+      if (pair.first)
+        return false;
+      pair = other;
+    }
+  }
+  return true;
+}
+
+void node_data::refresh_key_index(const shared_memory_holder& pMemory) {
+  if (m_pCollection && m_pCollection->pKeyIndex &&
+      m_pCollection->pKeyIndex->keyChanges != pMemory->key_changes())
+    build_key_index(pMemory);
+}
+
+void node_data::build_key_index(const shared_memory_holder& pMemory) {
+  collection& items = *m_pCollection;
+  items.pKeyIndex.reset(new key_index);
+  items.pKeyIndex->keyChanges = pMemory->key_changes();
+  for (const auto& mapEntry : items.map)
+    index_map_pair(mapEntry);
+}
+
+void node_data::index_map_pair(const kv_pair& pair) {
+  node& key = *pair.first;
+  key.mark_indexed_key();
+  if (key.type() == NodeType::Scalar) {
+    const std::string& scalar = key.scalar();
+    m_pCollection->pKeyIndex->byScalar.emplace(
+        hash_scalar(scalar.data(), scalar.size()), pair);
+  } else {
+    m_pCollection->pKeyIndex->others.push_back(pair);
+  }
+}
+
+void node_data::unindex_map_pair(const kv_pair& pair) {
+  if (!m_pCollection->pKeyIndex)
+    return;
+
+  auto& others = m_pCollection->pKeyIndex->others;
+  auto other = std::find(others.begin(), others.end(), pair);
+  if (other != others.end()) {
+    others.erase(other);
+    return;
+  }
+
+  // it should be under its key's scalar, unless that's changed since
+  auto& byScalar = m_pCollection->pKeyIndex->byScalar;
+  const std::string& scalar = pair.first->scalar();
+  const auto range =
+      byScalar.equal_range(hash_scalar(scalar.data(), scalar.size()));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == pair) {
+      byScalar.erase(it);
+      return;
+    }
+  }
+  for (auto it = byScalar.begin(); it != byScalar.end(); ++it) {
+    if (it->second == pair) {
+      byScalar.erase(it);
+      return;
+    }
+  }
 }
 
 void node_data::convert_to_map(const shared_memory_holder& pMemory) {
@@ -313,14 +513,15 @@ void node_data::convert_sequence_to_map(const shared_memory_holder& pMemory) {
   assert(m_type == NodeType::Sequence);
 
   reset_map();
-  for (std::size_t i = 0; i < m_sequence.size(); i++) {
+  const node_seq& sequence = m_pCollection->sequence;
+  for (std::size_t i = 0; i < sequence.size(); i++) {
     std::stringstream stream;
     stream.imbue(std::locale::classic());
     stream << i;
 
     node& key = pMemory->create_node();
     key.set_scalar(stream.str());
-    insert_map_pair(key, *m_sequence[i]);
+    insert_map_pair(key, *sequence[i], pMemory);
   }
 
   reset_sequence();
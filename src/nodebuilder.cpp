@@ -9,13 +9,15 @@
 namespace YAML {
 struct Mark;
 
-NodeBuilder::NodeBuilder()
-    : m_pMemory(std::make_shared<detail::memory_holder>()),
+NodeBuilder::NodeBuilder(Interning interning)
+    : m_interning(interning),
+      m_pMemory(std::make_shared<detail::memory_holder>()),
       m_pRoot(nullptr),
       m_stack{},
       m_anchors{},
       m_keys{},
-      m_mapDepth(0) {
+      m_mapDepth(0),
+      m_strings{} {
   m_anchors.push_back(nullptr);  // since the anchors start at 1
 }
 
@@ -28,6 +30,16 @@ Node NodeBuilder::Root() {
   return Node(*m_pRoot, m_pMemory);
 }
 
+void NodeBuilder::AppendMap(NodeBuilder& rhs) {
+  assert(m_pRoot && m_pRoot->type() == NodeType::Map);
+  assert(rhs.m_pRoot && rhs.m_pRoot->type() == NodeType::Map);
+
+  m_pMemory->merge(*rhs.m_pMemory);
+  m_strings.insert(rhs.m_strings.begin(), rhs.m_strings.end());
+  for (auto it = rhs.m_pRoot->begin(); it != rhs.m_pRoot->end(); ++it)
+    m_pRoot->insert(*it->first, *it->second, m_pMemory);
+}
+
 void NodeBuilder::OnDocumentStart(const Mark&) {}
 
 void NodeBuilder::OnDocumentEnd() {}
@@ -47,7 +59,10 @@ void NodeBuilder::OnAlias(const Mark& /* mark */, anchor_t anchor) {
 void NodeBuilder::OnScalar(const Mark& mark, const std::string& tag,
                            anchor_t anchor, const std::string& value) {
   detail::node& node = Push(mark, anchor);
-  node.set_scalar(value);
+  if (ShouldIntern(node, value))
+    node.set_shared_scalar(Intern(value));
+  else
+    node.set_shared_scalar(m_pMemory->store_string(value));
   node.set_tag(tag);
   Pop();
 }
@@ -125,6 +140,31 @@ void NodeBuilder::Pop() {
   }
 }
 
+bool NodeBuilder::ShouldIntern(const detail::node& node,
+                               const std::string& value) const {
+  switch (m_interning) {
+    case Interning::None:
+      return false;
+    case Interning::Keys:
+      break;
+    case Interning::KeysAndShortScalars:
+      if (value.size() <= kMaxShortScalar)
+        return true;
+      break;
+  }
+  return !m_keys.empty() && m_keys.back().first == &node;
+}
+
+const std::string& NodeBuilder::Intern(const std::string& value) {
+  const auto it = m_strings.find(&value);
+  if (it != m_strings.end())
+    return **it;
+
+  const std::string& interned = m_pMemory->store_string(value);
+  m_strings.insert(&interned);
+  return interned;
+}
+
 void NodeBuilder::RegisterAnchor(anchor_t anchor, detail::node& node) {
   if (anchor) {
     assert(anchor == m_anchors.size());
@@ -7,11 +7,16 @@
 #pragma once
 #endif
 
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/node/parse.h"
 #include "yaml-cpp/node/ptr.h"
 
 namespace YAML {
@@ -26,7 +31,7 @@ class Node;
 
 class NodeBuilder : public EventHandler {
  public:
-  NodeBuilder();
+  explicit NodeBuilder(Interning interning = Interning::None);
   NodeBuilder(const NodeBuilder&) = delete;
   NodeBuilder(NodeBuilder&&) = delete;
   NodeBuilder& operator=(const NodeBuilder&) = delete;
@@ -35,6 +40,14 @@ class NodeBuilder : public EventHandler {
 
   Node Root();
 
+  /**
+   * Adds the entries of {@code rhs}'s root map (which was built from a later
+   * part of the same top-level map) to this one's, taking over its memory.
+   *
+   * @throw NonUniqueMapKey if a key is repeated.
+   */
+  void AppendMap(NodeBuilder& rhs);
+
   void OnDocumentStart(const Mark& mark) override;
   void OnDocumentEnd() override;
 
@@ -57,7 +70,18 @@ class NodeBuilder : public EventHandler {
   void Pop();
   void RegisterAnchor(anchor_t anchor, detail::node& node);
 
+  /** Whether the scalar just pushed, {@code node}, is to be interned. */
+  bool ShouldIntern(const detail::node& node, const std::string& value) const;
+  /**
+   * Returns the memory's one copy of {@code value}, for every equal scalar
+   * that's interned while this builds.
+   */
+  const std::string& Intern(const std::string& value);
+
  private:
+  static const std::size_t kMaxShortScalar = 32;
+
+  Interning m_interning;
   detail::shared_memory_holder m_pMemory;
   detail::node* m_pRoot;
 
@@ -68,6 +92,20 @@ class NodeBuilder : public EventHandler {
   using PushedKey = std::pair<detail::node*, bool>;
   std::vector<PushedKey> m_keys;
   std::size_t m_mapDepth;
+
+  // only for as long as this builds, since it's not needed after (and would
+  // cost more than it saves, when few strings repeat)
+  struct StringHash {
+    std::size_t operator()(const std::string* value) const {
+      return std::hash<std::string>()(*value);
+    }
+  };
+  struct StringEqual {
+    bool operator()(const std::string* lhs, const std::string* rhs) const {
+      return *lhs == *rhs;
+    }
+  };
+  std::unordered_set<const std::string*, StringHash, StringEqual> m_strings;
 };
 }  // namespace YAML
 
@@ -1,72 +1,442 @@
 #include "yaml-cpp/node/parse.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <memory>
 #include <sstream>
+#include <thread>
 
+#include "directives.h"
+#include "keyfilter.h"
+#include "mappedfile.h"
 #include "nodebuilder.h"
+#include "scanner.h"
+#include "singledocparser.h"
+#include "stream.h"
+#include "token.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/lineindex.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
-Node Load(const std::string& input) {
-  std::stringstream stream(input);
-  return Load(stream);
+namespace {
+Node LoadFirst(Parser& parser, Interning interning = Interning::None) {
+  NodeBuilder builder(interning);
+  if (!parser.HandleNextDocument(builder)) {
+    return Node();
+  }
+
+  return builder.Root();
 }
 
-Node Load(const char* input) {
-  std::stringstream stream(input);
-  return Load(stream);
+// Removes what a selective parse in the given state wouldn't keep of the node:
+// the entries of a map whose keys aren't (plain or quoted) scalars that come
+// next on some path, all the way down.
+void KeepPaths(Node& node, const KeyFilter& filter, KeyFilter::State state) {
+  if (state == KeyFilter::All)
+    return;
+
+  if (node.IsSequence()) {
+    for (Node item : node)
+      KeepPaths(item, filter, state);
+  } else if (node.IsMap()) {
+    std::vector<Node> skipped;
+    for (const auto& pair : node) {
+      KeyFilter::State next;
+      if (pair.first.IsScalar() &&
+          (pair.first.Tag() == "?" || pair.first.Tag() == "!") &&
+          filter.Find(state, StringRef(pair.first.Scalar()), next)) {
+        Node value = pair.second;
+        KeepPaths(value, filter, next);
+      } else {
+        skipped.push_back(pair.first);
+      }
+    }
+    for (const Node& key : skipped)
+      node.remove(key);
+  }
 }
 
-Node Load(std::istream& input) {
-  Parser parser(input);
-  NodeBuilder builder;
-  if (!parser.HandleNextDocument(builder)) {
-    return Node();
+std::vector<Node> LoadEach(Parser& parser) {
+  std::vector<Node> docs;
+
+  while (true) {
+    NodeBuilder builder;
+    if (!parser.HandleNextDocument(builder)) {
+      break;
+    }
+    docs.push_back(builder.Root());
   }
 
-  return builder.Root();
+  return docs;
 }
 
-Node LoadFile(const std::string& filename) {
+// A part of the input that can be parsed on its own: it starts at the start
+// of the input, or of a line (where its marks start, too).
+struct Batch {
+  const char* data;
+  std::size_t size;
+  Mark start;
+};
+
+// What a line (at column 0) means for splitting the input into batches.
+enum class LineKind { Other, Split, End, Refuse };
+
+// Whether the line at p starts a document (as Exp::DocStart matches it), or
+// ends one (as Exp::DocEnd does).
+bool IsDocIndicator(const char* p, const char* end, const char* indicator) {
+  if (end - p < 3 || std::memcmp(p, indicator, 3) != 0)
+    return false;
+  return end - p == 3 || p[3] == ' ' || p[3] == '\t' || p[3] == '\r' ||
+         p[3] == '\n';
+}
+
+// Splits the input into about {@code count} batches of about the same size,
+// at lines that {@code classify} says it can split at, until one that it
+// says ends the splitting. Returns false if it can't be split (or needn't
+// be), since it isn't read in place, or {@code classify} refuses a line.
+template <typename Classify>
+bool SplitLines(const char* data, std::size_t size, std::size_t count,
+                char lineEnding, Classify classify,
+                std::vector<Batch>& batches) {
+  const Stream stream(data, size);
+  if (count < 2 || !stream.readsInPlace())
+    return false;
+
+  // the content starts after any byte order mark, and its marks from there
+  const char* const content = stream.window();
+  const char* const end = content + stream.windowSize();
+  const std::size_t target = stream.windowSize() / count + 1;
+
+  Batch batch{data, 0, Mark()};
+  int line = 0;
+  for (const char* p = content; p < end; line++) {
+    const LineKind kind = classify(p, end);
+    if (kind == LineKind::Refuse)
+      return false;
+    if (kind == LineKind::End)
+      break;
+
+    if (kind == LineKind::Split &&
+        p - batch.data >= static_cast<std::ptrdiff_t>(target)) {
+      batch.size = static_cast<std::size_t>(p - batch.data);
+      batches.push_back(batch);
+
+      batch.data = p;
+      batch.start.pos = static_cast<int>(p - content);
+      batch.start.line = line;
+    }
+
+    const void* next = std::memchr(p, lineEnding,
+                                   static_cast<std::size_t>(end - p));
+    if (!next)
+      break;
+    p = static_cast<const char*>(next) + 1;
+  }
+
+  batch.size = static_cast<std::size_t>(end - batch.data);
+  batches.push_back(batch);
+  return batches.size() > 1;
+}
+
+// Runs {@code work} on each batch, on up to {@code workers} threads (this one
+// included). Returns false if any of them does, or throws; after which the
+// rest are skipped.
+template <typename Work>
+bool WorkInParallel(std::size_t batches, std::size_t workers, Work work) {
+  std::atomic<std::size_t> nextBatch(0);
+  std::atomic<bool> failed(false);
+  const auto worker = [&]() {
+    for (std::size_t i = nextBatch++; i < batches && !failed;
+         i = nextBatch++) {
+      try {
+        if (!work(i))
+          failed = true;
+      } catch (...) {
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min(workers, batches); i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+  return !failed;
+}
+
+std::size_t WorkerCount(std::size_t workers) {
+  if (workers == 0)
+    workers = std::max(std::thread::hardware_concurrency(), 1u);
+  return workers;
+}
+
+// Loads the documents of one batch, as LoadEach would have loaded them from
+// the whole input; or returns false if it would have stopped partway.
+bool LoadBatch(const Batch& batch, char lineEnding, std::vector<Node>& docs) {
+  Scanner scanner(batch.data, batch.size, batch.start, lineEnding);
+  const Directives directives;
+
+  while (!scanner.empty()) {
+    const int oldPos = scanner.peek().mark.pos;
+
+    NodeBuilder builder;
+    SingleDocParser sdp(scanner, directives);
+    sdp.HandleDocument(builder);
+
+    // as in Parser::HandleNextDocument, stop if no progress was made
+    if (!scanner.empty() && scanner.peek().mark.pos == oldPos)
+      return false;
+    docs.push_back(builder.Root());
+  }
+  return true;
+}
+
+std::vector<Node> LoadEachParallel(const char* data, std::size_t size,
+                                   std::size_t workers) {
+  workers = WorkerCount(workers);
+
+  // a few batches for each thread, so that they finish at about the same
+  // time; split where documents start, unless there are directives (which
+  // carry over to later documents)
+  const char lineEnding = LineIndex(data, size).lineEnding();
+  const auto classify = [](const char* p, const char* end) {
+    if (*p == '%')
+      return LineKind::Refuse;
+    return IsDocIndicator(p, end, "---") ? LineKind::Split : LineKind::Other;
+  };
+  std::vector<Batch> batches;
+  if (workers < 2 || !SplitLines(data, size, workers * 4, lineEnding,
+                                 classify, batches)) {
+    Parser parser(data, size);
+    return LoadEach(parser);
+  }
+
+  std::vector<std::vector<Node>> results(batches.size());
+  const auto work = [&](std::size_t i) {
+    return LoadBatch(batches[i], lineEnding, results[i]);
+  };
+
+  // if that fails, the whole input is parsed again, on this thread, to end
+  // in just the same way (e.g., with the same exception)
+  if (!WorkInParallel(batches.size(), workers, work)) {
+    Parser parser(data, size);
+    return LoadEach(parser);
+  }
+
+  std::vector<Node> docs;
+  for (std::vector<Node>& result : results)
+    std::move(result.begin(), result.end(), std::back_inserter(docs));
+  return docs;
+}
+
+// Builds the entries of the top-level map in one batch, as LoadFirst would
+// have built them from the whole input; or returns false if it wouldn't
+// have (e.g., if they aren't a map). Only the last batch may go on past the
+// end of the document.
+bool LoadMapBatch(const Batch& batch, char lineEnding, bool last,
+                  NodeBuilder& builder) {
+  Scanner scanner(batch.data, batch.size, batch.start, lineEnding);
+  const Directives directives;
+  if (scanner.empty())
+    return false;
+
+  SingleDocParser sdp(scanner, directives);
+  sdp.HandleDocument(builder);
+  return (last || scanner.empty()) && builder.Root().IsMap();
+}
+
+Node LoadFirstParallel(const char* data, std::size_t size,
+                       std::size_t workers) {
+  workers = WorkerCount(workers);
+
+  // split before the keys of a top-level block map, which are at column 0
+  // (unlike what's in their values, except for flow collections and quoted
+  // scalars, which then fail to parse on their own), up to the end of the
+  // first document
+  const char lineEnding = LineIndex(data, size).lineEnding();
+  bool sawKey = false;
+  const auto classify = [&sawKey](const char* p, const char* end) {
+    if (*p == '%')
+      return LineKind::Refuse;
+    if (IsDocIndicator(p, end, "---") || IsDocIndicator(p, end, "..."))
+      return sawKey ? LineKind::End : LineKind::Other;
+    if (std::strchr(" \t\r\n#-?:", *p))
+      return LineKind::Other;
+    sawKey = true;
+    return LineKind::Split;
+  };
+  std::vector<Batch> batches;
+  if (workers < 2 || !SplitLines(data, size, workers * 4, lineEnding,
+                                 classify, batches)) {
+    Parser parser(data, size);
+    return LoadFirst(parser);
+  }
+
+  // each batch's entries go into their own memory, until they're all built
+  std::vector<std::unique_ptr<NodeBuilder>> builders(batches.size());
+  const auto work = [&](std::size_t i) {
+    builders[i].reset(new NodeBuilder);
+    return LoadMapBatch(batches[i], lineEnding, i + 1 == batches.size(),
+                        *builders[i]);
+  };
+
+  bool built = WorkInParallel(batches.size(), workers, work);
+  try {
+    for (std::size_t i = 1; built && i < builders.size(); i++)
+      builders[0]->AppendMap(*builders[i]);
+  } catch (const NonUniqueMapKey&) {
+    built = false;
+  }
+
+  // as above, anything else is parsed again on this thread
+  if (!built) {
+    Parser parser(data, size);
+    return LoadFirst(parser);
+  }
+  return builders[0]->Root();
+}
+
+Node LoadFirstFromFile(const std::string& filename, Interning interning) {
+  MappedFile file;
+  if (file.Open(filename)) {
+    Parser parser(file.data(), file.size());
+    return LoadFirst(parser, interning);
+  }
+
   std::ifstream fin(filename);
   if (!fin) {
     throw BadFile(filename);
   }
-  return Load(fin);
+  Parser parser(fin);
+  return LoadFirst(parser, interning);
 }
+}  // namespace
 
-std::vector<Node> LoadAll(const std::string& input) {
-  std::stringstream stream(input);
-  return LoadAll(stream);
+Node Load(const std::string& input) {
+  Parser parser(input.data(), input.size());
+  return LoadFirst(parser);
 }
 
-std::vector<Node> LoadAll(const char* input) {
-  std::stringstream stream(input);
-  return LoadAll(stream);
+Node Load(const std::string& input, Interning interning) {
+  Parser parser(input.data(), input.size());
+  return LoadFirst(parser, interning);
 }
 
-std::vector<Node> LoadAll(std::istream& input) {
-  std::vector<Node> docs;
+Node Load(const char* input) {
+  Parser parser(input, std::strlen(input));
+  return LoadFirst(parser);
+}
 
+Node Load(std::istream& input) {
   Parser parser(input);
-  while (true) {
-    NodeBuilder builder;
-    if (!parser.HandleNextDocument(builder)) {
-      break;
+  return LoadFirst(parser);
+}
+
+Node LoadFile(const std::string& filename) {
+  return LoadFirstFromFile(filename, Interning::None);
+}
+
+Node LoadFile(const std::string& filename, Interning interning) {
+  return LoadFirstFromFile(filename, interning);
+}
+
+Node LoadPaths(const std::string& input,
+               const std::vector<std::vector<std::string>>& paths) {
+  Parser parser(input.data(), input.size());
+  NodeBuilder builder;
+  try {
+    if (!parser.HandleNextDocument(builder, paths)) {
+      return Node();
     }
-    docs.push_back(builder.Root());
+  } catch (const ParserException& e) {
+    // An alias to an anchor that was skipped (so never registered) can only
+    // be resolved by loading the whole document, and then dropping the rest.
+    const std::size_t size = std::strlen(ErrorMsg::UNKNOWN_ANCHOR);
+    if (e.msg.compare(0, size, ErrorMsg::UNKNOWN_ANCHOR) != 0) {
+      throw;
+    }
+    Node document = Load(input);
+    const KeyFilter filter(paths);
+    KeepPaths(document, filter, filter.root());
+    return document;
   }
 
-  return docs;
+  return builder.Root();
+}
+
+std::vector<Node> LoadAll(const std::string& input) {
+  Parser parser(input.data(), input.size());
+  return LoadEach(parser);
+}
+
+std::vector<Node> LoadAll(const char* input) {
+  Parser parser(input, std::strlen(input));
+  return LoadEach(parser);
+}
+
+std::vector<Node> LoadAll(std::istream& input) {
+  Parser parser(input);
+  return LoadEach(parser);
 }
 
 std::vector<Node> LoadAllFromFile(const std::string& filename) {
+  MappedFile file;
+  if (file.Open(filename)) {
+    Parser parser(file.data(), file.size());
+    return LoadEach(parser);
+  }
+
   std::ifstream fin(filename);
   if (!fin) {
     throw BadFile(filename);
   }
   return LoadAll(fin);
 }
+Node LoadParallel(const std::string& input, std::size_t workers) {
+  return LoadFirstParallel(input.data(), input.size(), workers);
+}
+
+Node LoadFileParallel(const std::string& filename, std::size_t workers) {
+  MappedFile file;
+  if (file.Open(filename)) {
+    return LoadFirstParallel(file.data(), file.size(), workers);
+  }
+
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  std::stringstream input;
+  input << fin.rdbuf();
+  return LoadParallel(input.str(), workers);
+}
+
+std::vector<Node> LoadAllParallel(const std::string& input,
+                                  std::size_t workers) {
+  return LoadEachParallel(input.data(), input.size(), workers);
+}
+
+std::vector<Node> LoadAllFromFileParallel(const std::string& filename,
+                                          std::size_t workers) {
+  MappedFile file;
+  if (file.Open(filename)) {
+    return LoadEachParallel(file.data(), file.size(), workers);
+  }
+
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  std::stringstream input;
+  input << fin.rdbuf();
+  return LoadAllParallel(input.str(), workers);
+}
 }  // namespace YAML
@@ -1,30 +1,79 @@
 #include <cstdio>
 #include <sstream>
+#include <utility>
 
 #include "directives.h"  // IWYU pragma: keep
+#include "keyfilter.h"
+#include "pushinput.h"
 #include "scanner.h"     // IWYU pragma: keep
 #include "singledocparser.h"
 #include "token.h"
+#include "yaml-cpp/depthguard.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/refeventhandler.h"
 
 namespace YAML {
-class EventHandler;
+namespace {
+// Rethrows the exception that's being handled with its mark in full, if the
+// scanner only kept its offset.
+[[noreturn]] void RethrowLocated(const Scanner& scanner,
+                                 const ParserException& e) {
+  const Mark mark = scanner.Locate(e.mark);
+  if (mark.line == e.mark.line)
+    throw;
+  if (const DeepRecursion* deep = dynamic_cast<const DeepRecursion*>(&e))
+    throw DeepRecursion(deep->depth(), mark, e.msg);
+  throw ParserException(mark, e.msg);
+}
+}  // namespace
 
-Parser::Parser() : m_pScanner{}, m_pDirectives{} {}
+Parser::Parser() : m_pScanner{}, m_pDirectives{}, m_pPushInput{} {}
 
 Parser::Parser(std::istream& in) : Parser() { Load(in); }
 
+Parser::Parser(const char* data, std::size_t size, MarkMode marks)
+    : Parser() {
+  Load(data, size, marks);
+}
+
 Parser::~Parser() = default;
 
 Parser::operator bool() const { return m_pScanner && !m_pScanner->empty(); }
 
 void Parser::Load(std::istream& in) {
+  m_pPushInput.reset();
   m_pScanner.reset(new Scanner(in));
   m_pDirectives.reset(new Directives);
 }
 
-bool Parser::HandleNextDocument(EventHandler& eventHandler) {
+void Parser::Load(const char* data, std::size_t size, MarkMode marks) {
+  m_pPushInput.reset();
+  m_pScanner.reset(new Scanner(data, size, marks));
+  m_pDirectives.reset(new Directives);
+}
+
+void Parser::Load(EventHandler& eventHandler) {
+  m_pScanner.reset();
+  m_pDirectives.reset();
+  m_pPushInput.reset(new PushInput(eventHandler));
+}
+
+void Parser::Feed(const char* data, std::size_t size) {
+  if (m_pPushInput) {
+    m_pPushInput->Feed(data, size);
+  }
+}
+
+void Parser::Finish() {
+  std::unique_ptr<PushInput> pPushInput(std::move(m_pPushInput));
+  if (pPushInput) {
+    pPushInput->Finish();
+  }
+}
+
+template <typename Handler>
+bool Parser::HandleDocument(Handler& eventHandler, const KeyFilter* filter) {
   if (!m_pScanner)
     return false;
 
@@ -35,7 +84,7 @@ bool Parser::HandleNextDocument(EventHandler& eventHandler) {
 
   auto oldPos = m_pScanner->peek().mark.pos;
 
-  SingleDocParser sdp(*m_pScanner, *m_pDirectives);
+  SingleDocParser sdp(*m_pScanner, *m_pDirectives, filter);
   sdp.HandleDocument(eventHandler);
 
   // checks if progress was made
@@ -53,6 +102,33 @@ bool Parser::HandleNextDocument(EventHandler& eventHandler) {
   return false;
 }
 
+bool Parser::HandleNextDocument(EventHandler& eventHandler) {
+  try {
+    return HandleDocument(eventHandler);
+  } catch (const ParserException& e) {
+    RethrowLocated(*m_pScanner, e);
+  }
+}
+
+bool Parser::HandleNextDocument(RefEventHandler& eventHandler) {
+  try {
+    return HandleDocument(eventHandler);
+  } catch (const ParserException& e) {
+    RethrowLocated(*m_pScanner, e);
+  }
+}
+
+bool Parser::HandleNextDocument(
+    EventHandler& eventHandler,
+    const std::vector<std::vector<std::string>>& paths) {
+  const KeyFilter filter(paths);
+  try {
+    return HandleDocument(eventHandler, &filter);
+  } catch (const ParserException& e) {
+    RethrowLocated(*m_pScanner, e);
+  }
+}
+
 void Parser::ParseDirectives() {
   bool readDirective = false;
 
@@ -0,0 +1,104 @@
+#include "pushinput.h"
+
+#include "scanner.h"
+#include "singledocparser.h"
+#include "stream.h"
+#include "token.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/eventreader.h"
+
+namespace YAML {
+PushInput::PushInput(EventHandler& eventHandler)
+    : m_eventHandler(eventHandler),
+      m_done(false),
+      m_parser(),
+      m_pDocument{},
+      m_docStartPos(0),
+      m_directives{},
+      m_retrySize(0) {
+  m_parser.m_pScanner.reset(new Scanner);
+  m_parser.m_pDirectives.reset(new Directives);
+}
+
+PushInput::~PushInput() = default;
+
+void PushInput::Feed(const char* data, std::size_t size) {
+  if (m_done || size == 0) {
+    return;
+  }
+
+  Scanner& scanner = *m_parser.m_pScanner;
+  scanner.Push(data, size);
+  if (scanner.pushedSize() < m_retrySize) {
+    return;
+  }
+  try {
+    Parse();
+  } catch (...) {
+    m_done = true;
+    throw;
+  }
+}
+
+void PushInput::Finish() {
+  if (m_done) {
+    return;
+  }
+  m_done = true;
+  m_parser.m_pScanner->Close();
+  Parse();
+}
+
+void PushInput::Parse() {
+  Scanner& scanner = *m_parser.m_pScanner;
+  try {
+    while (true) {
+      if (!m_pDocument && !StartDocument()) {
+        m_done = true;
+        return;
+      }
+
+      Event event;
+      m_pDocument->Save();
+      if (m_pDocument->HandleNextEvent(event)) {
+        scanner.Commit();
+        m_pDocument->HandleEvent(m_eventHandler, event);
+        continue;
+      }
+
+      // as in Parser::HandleNextDocument, stop if no progress was made
+      const bool stuck =
+          !scanner.empty() && scanner.peek().mark.pos == m_docStartPos;
+      m_pDocument.reset();
+      scanner.Commit();
+      if (stuck) {
+        m_done = true;
+        return;
+      }
+    }
+  } catch (const MoreInputNeeded&) {
+    // go back to before the event, or the directives
+    scanner.Rewind();
+    if (m_pDocument) {
+      m_pDocument->Restore();
+    } else {
+      m_parser.m_pDirectives.reset(new Directives(m_directives));
+    }
+    m_retrySize = 2 * scanner.pushedSize();
+  }
+}
+
+bool PushInput::StartDocument() {
+  Scanner& scanner = *m_parser.m_pScanner;
+  m_directives = *m_parser.m_pDirectives;
+  m_parser.ParseDirectives();
+  if (scanner.empty()) {
+    return false;
+  }
+
+  m_docStartPos = scanner.peek().mark.pos;
+  m_pDocument.reset(new SingleDocParser(scanner, *m_parser.m_pDirectives));
+  scanner.Commit();
+  return true;
+}
+}  // namespace YAML
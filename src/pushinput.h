@@ -0,0 +1,67 @@
+#ifndef PUSHINPUT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PUSHINPUT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+
+#include "directives.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+class EventHandler;
+class SingleDocParser;
+
+/**
+ * Parses input that is pushed to it in chunks.
+ *
+ * The scanner and the document's parser are kept from one chunk to the next.
+ * Each event is read (on the caller's thread) as soon as there's enough input
+ * for it, and sent; when there isn't, both go back to where they were before
+ * it, and try again once there's more. Only the input from the start of the
+ * token that the scanner's on is kept.
+ */
+class PushInput {
+ public:
+  explicit PushInput(EventHandler& eventHandler);
+  PushInput(const PushInput&) = delete;
+  PushInput(PushInput&&) = delete;
+  PushInput& operator=(const PushInput&) = delete;
+  PushInput& operator=(PushInput&&) = delete;
+  ~PushInput();
+
+  void Feed(const char* data, std::size_t size);
+  void Finish();
+
+ private:
+  /** Sends the events that there's enough input for (or all of them). */
+  void Parse();
+
+  /**
+   * Reads the directives before the next document, and starts it.
+   *
+   * @return false if there are no more documents
+   */
+  bool StartDocument();
+
+ private:
+  EventHandler& m_eventHandler;
+  bool m_done;  // finished, or failed
+
+  Parser m_parser;
+  std::unique_ptr<SingleDocParser> m_pDocument;
+  int m_docStartPos;
+  Directives m_directives;  // the last document's, while the next's are read
+
+  // how much input to keep before trying again, after running out: twice
+  // as much as last time, so that a long token isn't scanned over and over
+  std::size_t m_retrySize;
+};
+}  // namespace YAML
+
+#endif  // PUSHINPUT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,17 +1,93 @@
 #include "regex_yaml.h"
 
 namespace YAML {
+namespace {
+// A source over the first few characters of a Stream, for tabulating a RegEx:
+// it notes whether the match looked any further than them, in which case its
+// result doesn't depend on them alone.
+class ProbeSource {
+ public:
+  ProbeSource(const char* chars, std::size_t size, bool& beyond)
+      : m_chars(chars), m_size(size), m_offset(0), m_beyond(beyond) {}
+
+  operator bool() const { return Known(0); }
+  char operator[](std::size_t i) const {
+    return Known(i) ? m_chars[m_offset + i] : Stream::eof();
+  }
+  const ProbeSource operator+(int i) const {
+    ProbeSource source(*this);
+    if (static_cast<int>(source.m_offset) + i >= 0)
+      source.m_offset += static_cast<std::size_t>(i);
+    else
+      source.m_offset = 0;
+    return source;
+  }
+
+ private:
+  bool Known(std::size_t i) const {
+    if (m_offset + i < m_size)
+      return true;
+    m_beyond = true;
+    return false;
+  }
+
+  const char* m_chars;
+  std::size_t m_size;
+  std::size_t m_offset;
+  bool& m_beyond;
+};
+}  // namespace
+
 // constructors
 
-RegEx::RegEx(REGEX_OP op) : m_op(op), m_a(0), m_z(0), m_params{} {}
+RegEx::RegEx(REGEX_OP op)
+    : m_op(op), m_a(0), m_z(0), m_params{}, m_pTable{} {}
 RegEx::RegEx() : RegEx(REGEX_EMPTY) {}
 
-RegEx::RegEx(char ch) : m_op(REGEX_MATCH), m_a(ch), m_z(0), m_params{} {}
+RegEx::RegEx(char ch)
+    : m_op(REGEX_MATCH), m_a(ch), m_z(0), m_params{}, m_pTable{} {}
 
-RegEx::RegEx(char a, char z) : m_op(REGEX_RANGE), m_a(a), m_z(z), m_params{} {}
+RegEx::RegEx(char a, char z)
+    : m_op(REGEX_RANGE), m_a(a), m_z(z), m_params{}, m_pTable{} {}
 
 RegEx::RegEx(const std::string& str, REGEX_OP op)
-    : m_op(op), m_a(0), m_z(0), m_params(str.begin(), str.end()) {}
+    : m_op(op), m_a(0), m_z(0), m_params(str.begin(), str.end()),
+      m_pTable{} {}
+
+RegEx RegEx::Compiled() const {
+  std::shared_ptr<Table> pTable = std::make_shared<Table>();
+  for (int first = 0; first < 256; first++) {
+    char chars[2] = {static_cast<char>(first), 0};
+    bool beyond = false;
+    const int n = Match(ProbeSource(chars, 1, beyond));
+    pTable->byFirst[first] =
+        static_cast<signed char>(beyond ? Table::kUnknown : n);
+
+    // an eof here may be a real character or the end of the stream, so what
+    // follows it is left to the tree
+    if (!beyond || chars[0] == Stream::eof() || pTable->bySecond.size() >= 255)
+      continue;
+
+    std::array<signed char, 256> bySecond;
+    bool known = false;
+    for (int second = 0; second < 256; second++) {
+      chars[1] = static_cast<char>(second);
+      beyond = false;
+      const int m = Match(ProbeSource(chars, 2, beyond));
+      bySecond[second] = static_cast<signed char>(beyond ? Table::kUnknown : m);
+      known = known || !beyond;
+    }
+    if (!known)
+      continue;
+    pTable->bySecond.push_back(bySecond);
+    pTable->secondIndex[first] =
+        static_cast<unsigned char>(pTable->bySecond.size());
+  }
+
+  RegEx ret(*this);
+  ret.m_pTable = pTable;
+  return ret;
+}
 
 // combination constructors
 RegEx operator!(const RegEx& ex) {
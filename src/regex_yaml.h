@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -52,7 +53,18 @@ class YAML_CPP_API RegEx {
   template <typename Source>
   int Match(const Source& source) const;
 
+  // Returns a copy of this expression that matches a Stream by looking up its
+  // first one or two characters in a table, and only walks the tree when
+  // those don't decide the match.
+  RegEx Compiled() const;
+
+  // Whether this expression, compiled, can't match a Stream that starts with
+  // the given character. Always false if it isn't compiled.
+  bool CantStartWith(char ch) const;
+
  private:
+  struct Table;
+
   explicit RegEx(REGEX_OP op);
 
   template <typename Source>
@@ -80,6 +92,7 @@ class YAML_CPP_API RegEx {
   char m_a{};
   char m_z{};
   std::vector<RegEx> m_params;
+  std::shared_ptr<const Table> m_pTable;
 };
 }  // namespace YAML
 
@@ -7,11 +7,38 @@
 #pragma once
 #endif
 
+#include <array>
+#include <vector>
+
 #include "stream.h"
 #include "streamcharsource.h"
 #include "stringsource.h"
 
 namespace YAML {
+// The result of matching a compiled RegEx against a Stream, by its first
+// character and, for the first characters that don't decide it alone, by its
+// second. kUnknown means that the tree has to be walked.
+struct RegEx::Table {
+  enum { kUnknown = -2 };
+
+  int Match(const StreamCharSource& source) const {
+    if (!source)
+      return -1;
+    const unsigned char first = static_cast<unsigned char>(source[0]);
+    if (byFirst[first] != kUnknown || secondIndex[first] == 0)
+      return byFirst[first];
+    const StreamCharSource next = source + 1;
+    if (!next)
+      return kUnknown;
+    const unsigned char second = static_cast<unsigned char>(next[0]);
+    return bySecond[secondIndex[first] - 1][second];
+  }
+
+  std::array<signed char, 256> byFirst{};
+  std::array<unsigned char, 256> secondIndex{};  // 1-based; 0 if none
+  std::vector<std::array<signed char, 256>> bySecond{};
+};
+
 // query matches
 inline bool RegEx::Matches(char ch) const {
   std::string str;
@@ -46,8 +73,17 @@ inline int RegEx::Match(const std::string& str) const {
   return Match(source);
 }
 
+inline bool RegEx::CantStartWith(char ch) const {
+  return m_pTable && m_pTable->byFirst[static_cast<unsigned char>(ch)] == -1;
+}
+
 inline int RegEx::Match(const Stream& in) const {
   StreamCharSource source(in);
+  if (m_pTable) {
+    const int n = m_pTable->Match(source);
+    if (n != Table::kUnknown)
+      return n;
+  }
   return Match(source);
 }
 
@@ -1,5 +1,8 @@
 #include <cassert>
+#include <cctype>
+#include <cstring>
 #include <memory>
+#include <string>
 
 #include "exp.h"
 #include "scanner.h"
@@ -18,6 +21,195 @@ namespace {
 //   that they can't contribute to indentation, so once you've seen a tab in a
 //   line, you can't start a simple key
 bool IsWhitespaceToBeEaten(char ch) { return (ch == ' ') || (ch == '\t'); }
+
+// CountWhitespaceToBeEaten
+// . The length of the run of whitespace at the start of [chars, chars + size),
+//   and whether it has a tab in it
+std::size_t CountWhitespaceToBeEaten(const char* chars, std::size_t size,
+                                     bool& sawTab) {
+  std::size_t n = 0;
+  for (; n < size && IsWhitespaceToBeEaten(chars[n]); n++) {
+    if (chars[n] == '\t')
+      sawTab = true;
+  }
+  return n;
+}
+
+// CountToLineBreak
+// . The length of the rest of a line (e.g., the body of a comment) at the
+//   start of [chars, chars + size), up to a line break or an eof character.
+//   It only looks for the rarer ones within the line that memchr finds.
+std::size_t CountToLineBreak(const char* chars, std::size_t size) {
+  const void* lf = std::memchr(chars, '\n', size);
+  std::size_t n =
+      lf ? static_cast<std::size_t>(static_cast<const char*>(lf) - chars)
+         : size;
+  if (const void* cr = std::memchr(chars, '\r', n))
+    n = static_cast<std::size_t>(static_cast<const char*>(cr) - chars);
+  if (const void* eof = std::memchr(chars, Stream::eof(), n))
+    n = static_cast<std::size_t>(static_cast<const char*>(eof) - chars);
+  return n;
+}
+
+// IsBlockScalarHeader
+// . Whether [p, end) starts with a block scalar's header ('|' or '>', with
+//   any indentation and chomping indicators), which ends the line (but for a
+//   comment)
+bool IsBlockScalarHeader(const char* p, const char* end) {
+  if (p == end || (*p != '|' && *p != '>'))
+    return false;
+  for (++p; p < end && (std::isdigit(static_cast<unsigned char>(*p)) ||
+                        *p == '+' || *p == '-');
+       ++p) {
+  }
+  if (p == end)
+    return true;
+  if (*p != ' ' && *p != '\t')
+    return false;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    ++p;
+  return p == end || *p == '#';
+}
+
+// the characters that matter to ScanValueLine; it passes over the rest
+struct ValueLineTable {
+  ValueLineTable() : special{} {
+    for (char ch : std::string("\"'[{]}#|>"))
+      special[static_cast<unsigned char>(ch)] = true;
+  }
+
+  bool special[256];
+};
+
+const ValueLineTable& ValueTable() {
+  static const ValueLineTable table;
+  return table;
+}
+
+// ScanValueLine
+// . Whether a line of a block map's value, [p, end), leaves nothing open at
+//   its end: no flow collection or quoted scalar that goes on to the next
+//   line (which could then go on to the left of the value's indentation)
+// . Sets {@code blockScalar} if a block scalar starts on it, whose lines
+//   aren't to be scanned like this
+// . This is conservative: e.g., a '[' at the start of a word of a plain
+//   scalar counts too
+bool ScanValueLine(const char* p, const char* end, bool& blockScalar) {
+  const bool* const special = ValueTable().special;
+  const char* const begin = p;
+  blockScalar = false;
+  int depth = 0;
+  for (;; ++p) {
+    while (p < end && !special[static_cast<unsigned char>(*p)])
+      ++p;
+    if (p == end)
+      break;
+
+    const char ch = *p;
+    const bool token =
+        depth > 0 || p == begin || p[-1] == ' ' || p[-1] == '\t';
+    if (!token)
+      continue;
+    if (depth == 0 && ch == '#')
+      break;
+    if (ch == '"' || ch == '\'') {
+      // to its closing quote, past any escapes
+      while (true) {
+        p = static_cast<const char*>(
+            std::memchr(p + 1, ch, static_cast<std::size_t>(end - p - 1)));
+        if (!p)
+          return false;
+        if (ch == '\'' && p + 1 < end && p[1] == '\'') {
+          ++p;
+          continue;
+        }
+        const char* escape = p;
+        while (ch == '"' && escape[-1] == '\\')
+          --escape;
+        if ((p - escape) % 2 == 0)
+          break;
+      }
+    } else if (ch == '[' || ch == '{') {
+      depth++;
+    } else if (ch == ']' || ch == '}') {
+      if (depth > 0)
+        depth--;
+    } else if (depth == 0 && IsBlockScalarHeader(p, end)) {
+      blockScalar = true;
+      break;
+    }
+  }
+  return depth == 0;
+}
+
+// CountBlockValue
+// . The length of a block map's value at the start of [chars, chars + size),
+//   which is just after its ':', where the map's keys are at column
+//   {@code indent}; it ends with the last line that's part of it (before
+//   that line's break)
+// . Returns false if there's an eof character in it, which is left for the
+//   scanner to deal with; or if a flow collection or a quoted scalar in it
+//   goes on past a line, or a line starts with a tab, since then its lines'
+//   indentation says nothing
+bool CountBlockValue(const char* chars, std::size_t size, int indent,
+                     std::size_t& n) {
+  const char* const end = chars + size;
+  const char* p = chars + CountToLineBreak(chars, size);
+  if (p < end && *p == Stream::eof())
+    return false;
+
+  // a sequence can only be as indented as the keys if it starts on the next
+  // line (perhaps after the value's properties)
+  const char* first = chars;
+  while (first < p && IsWhitespaceToBeEaten(*first))
+    ++first;
+  const bool indentlessSeq =
+      first == p || *first == '#' || *first == '!' || *first == '&';
+
+  // the lines of a block scalar (those more indented than the line that
+  // starts it) are just text
+  bool blockScalar = false;
+  if (!ScanValueLine(chars, p, blockScalar))
+    return false;
+  int blockScalarColumn = blockScalar ? indent : -1;
+
+  const char* valueEnd = p;
+  while (p < end) {
+    p += (*p == '\r' && p + 1 < end && p[1] == '\n') ? 2 : 1;
+    const char* line = p;
+    while (line < end && *line == ' ')
+      ++line;
+    // (a tab isn't indentation, but it can still go before a value's line)
+    if (line < end && *line == '\t')
+      return false;
+    const char* lineEnd =
+        line + CountToLineBreak(line, static_cast<std::size_t>(end - line));
+    if (lineEnd < end && *lineEnd == Stream::eof())
+      return false;
+
+    const int column = static_cast<int>(line - p);
+    const bool blank = line == lineEnd || *line == '#';
+    const bool entry = column == indent && indentlessSeq && *line == '-' &&
+                       (line + 1 == lineEnd || line[1] == ' ' ||
+                        line[1] == '\t');
+    if (!blank && column <= indent && !entry)
+      break;
+
+    if (!blank && column <= blockScalarColumn)
+      blockScalarColumn = -1;
+    if (!blank && blockScalarColumn < 0) {
+      if (!ScanValueLine(line, lineEnd, blockScalar))
+        return false;
+      if (blockScalar)
+        blockScalarColumn = column;
+    }
+
+    valueEnd = p = lineEnd;
+  }
+
+  n = static_cast<std::size_t>(valueEnd - chars);
+  return true;
+}
 }  // namespace
 
 Scanner::Scanner(std::istream& in)
@@ -31,7 +223,53 @@ Scanner::Scanner(std::istream& in)
       m_simpleKeys{},
       m_indents{},
       m_indentRefs{},
-      m_flows{} {}
+      m_flows{},
+      m_checkpoint{} {}
+
+Scanner::Scanner(const char* data, std::size_t size, MarkMode marks)
+    : INPUT(data, size, marks),
+      m_tokens{},
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_scalarValueAllowed(false),
+      m_canBeJSONFlow(false),
+      m_simpleKeys{},
+      m_indents{},
+      m_indentRefs{},
+      m_flows{},
+      m_checkpoint{} {}
+
+Scanner::Scanner(const char* data, std::size_t size, const Mark& start,
+                 char lineEnding)
+    : INPUT(data, size, start, lineEnding),
+      m_tokens{},
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_scalarValueAllowed(false),
+      m_canBeJSONFlow(false),
+      m_simpleKeys{},
+      m_indents{},
+      m_indentRefs{},
+      m_flows{},
+      m_checkpoint{} {}
+
+Scanner::Scanner()
+    : INPUT(),
+      m_tokens{},
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_scalarValueAllowed(false),
+      m_canBeJSONFlow(false),
+      m_simpleKeys{},
+      m_indents{},
+      m_indentRefs{},
+      m_flows{},
+      m_checkpoint{} {
+  m_tokens.hold();
+}
 
 Scanner::~Scanner() = default;
 
@@ -64,6 +302,24 @@ Token& Scanner::peek() {
 
 Mark Scanner::mark() const { return INPUT.mark(); }
 
+bool Scanner::SkipBlockValue() {
+  if (!m_tokens.empty() || !InBlockContext() || !INPUT.readsInPlace() ||
+      m_indents.empty())
+    return false;
+
+  const IndentMarker& indent = *m_indents.top();
+  if (indent.type != IndentMarker::MAP || indent.status != IndentMarker::VALID)
+    return false;
+
+  std::size_t n = 0;
+  if (!CountBlockValue(INPUT.window(), INPUT.windowSize(), indent.column, n))
+    return false;
+
+  // we stop at a line break (or the end), which is scanned as usual
+  INPUT.eatLines(n);
+  return true;
+}
+
 void Scanner::EnsureTokensInQueue() {
   while (true) {
     if (!m_tokens.empty()) {
@@ -89,7 +345,11 @@ void Scanner::EnsureTokensInQueue() {
     }
 
     // no? then scan...
-    ScanNextToken();
+    if (INPUT.pushed()) {
+      ScanNextPushedToken();
+    } else {
+      ScanNextToken();
+    }
   }
 }
 
@@ -224,21 +484,83 @@ void Scanner::ScanNextToken() {
   throw ParserException(INPUT.mark(), ErrorMsg::UNKNOWN_TOKEN);
 }
 
+void Scanner::ScanNextPushedToken() {
+  Checkpoint& saved = m_checkpoint;
+  saved.tokens = m_tokens.size();
+  saved.indentRefs = m_indentRefs.size();
+  saved.startedStream = m_startedStream;
+  saved.endedStream = m_endedStream;
+  saved.simpleKeyAllowed = m_simpleKeyAllowed;
+  saved.scalarValueAllowed = m_scalarValueAllowed;
+  saved.canBeJSONFlow = m_canBeJSONFlow;
+  saved.simpleKeys = m_simpleKeys;
+  saved.indents = m_indents;
+  saved.flows = m_flows;
+  if (!m_simpleKeys.empty()) {
+    const SimpleKey& key = m_simpleKeys.top();
+    if (key.pIndent)
+      saved.indentStatus = key.pIndent->status;
+    if (key.pMapStart)
+      saved.mapStartStatus = key.pMapStart->status;
+    if (key.pKey)
+      saved.keyStatus = key.pKey->status;
+  }
+  INPUT.Save();
+
+  try {
+    ScanNextToken();
+  } catch (const MoreInputNeeded&) {
+    INPUT.Restore();
+    m_tokens.truncate(saved.tokens);
+    m_indentRefs.erase(
+        m_indentRefs.begin() + static_cast<std::ptrdiff_t>(saved.indentRefs),
+        m_indentRefs.end());
+    m_startedStream = saved.startedStream;
+    m_endedStream = saved.endedStream;
+    m_simpleKeyAllowed = saved.simpleKeyAllowed;
+    m_scalarValueAllowed = saved.scalarValueAllowed;
+    m_canBeJSONFlow = saved.canBeJSONFlow;
+    m_simpleKeys = saved.simpleKeys;
+    m_indents = saved.indents;
+    m_flows = saved.flows;
+    if (!m_simpleKeys.empty()) {
+      const SimpleKey& key = m_simpleKeys.top();
+      if (key.pIndent)
+        key.pIndent->status = saved.indentStatus;
+      if (key.pMapStart)
+        key.pMapStart->status = saved.mapStartStatus;
+      if (key.pKey)
+        key.pKey->status = saved.keyStatus;
+    }
+    throw;
+  }
+}
+
 void Scanner::ScanToNextToken() {
   while (true) {
-    // first eat whitespace
+    // first eat whitespace, a run at a time (the window may end mid-run)
     while (INPUT && IsWhitespaceToBeEaten(INPUT.peek())) {
-      if (InBlockContext() && Exp::Tab().Matches(INPUT)) {
+      bool sawTab = false;
+      const std::size_t n =
+          CountWhitespaceToBeEaten(INPUT.window(), INPUT.windowSize(), sawTab);
+      if (InBlockContext() && sawTab) {
         m_simpleKeyAllowed = false;
       }
-      INPUT.eat(1);
+      INPUT.eatInLine(n);
     }
 
     // then eat a comment
     if (Exp::Comment().Matches(INPUT)) {
-      // eat until line break
+      // eat until line break, again a run at a time (but a stray eof
+      // character, in the middle of the input, goes one at a time)
       while (INPUT && !Exp::Break().Matches(INPUT)) {
-        INPUT.eat(1);
+        const std::size_t n =
+            CountToLineBreak(INPUT.window(), INPUT.windowSize());
+        if (n > 0) {
+          INPUT.eatInLine(n);
+        } else {
+          INPUT.eat(1);
+        }
       }
     }
 
@@ -279,9 +601,7 @@ void Scanner::StartStream() {
   m_startedStream = true;
   m_simpleKeyAllowed = true;
   m_scalarValueAllowed = true;
-  std::unique_ptr<IndentMarker> pIndent(
-      new IndentMarker(-1, IndentMarker::NONE));
-  m_indentRefs.push_back(std::move(pIndent));
+  m_indentRefs.emplace_back(-1, IndentMarker::NONE);
   m_indents.push(&m_indentRefs.back());
 }
 
@@ -293,6 +613,7 @@ void Scanner::EndStream() {
 
   PopAllIndents();
   PopAllSimpleKeys();
+  ReleasePoppedIndents();
 
   m_simpleKeyAllowed = false;
   m_scalarValueAllowed = false;
@@ -325,8 +646,7 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
     return nullptr;
   }
 
-  std::unique_ptr<IndentMarker> pIndent(new IndentMarker(column, type));
-  IndentMarker& indent = *pIndent;
+  IndentMarker indent(column, type);
   const IndentMarker& lastIndent = *m_indents.top();
 
   // is this actually an indentation?
@@ -343,8 +663,8 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
   indent.pStartToken = PushToken(GetStartTokenFor(type));
 
   // and then the indent
-  m_indents.push(&indent);
-  m_indentRefs.push_back(std::move(pIndent));
+  m_indentRefs.push_back(indent);
+  m_indents.push(&m_indentRefs.back());
   return &m_indentRefs.back();
 }
 
@@ -411,6 +731,15 @@ void Scanner::PopIndent() {
   }
 }
 
+void Scanner::ReleasePoppedIndents() {
+  // only the base indentation is left (which is the first)
+  if (!m_simpleKeys.empty() || m_indents.size() != 1 ||
+      m_indentRefs.size() <= 1) {
+    return;
+  }
+  m_indentRefs.erase(m_indentRefs.begin() + 1, m_indentRefs.end());
+}
+
 int Scanner::GetTopIndent() const {
   if (m_indents.empty()) {
     return 0;
@@ -8,14 +8,15 @@
 #endif
 
 #include <cstddef>
+#include <deque>
 #include <ios>
-#include <queue>
 #include <stack>
 #include <string>
+#include <vector>
 
-#include "ptr_vector.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
@@ -28,6 +29,27 @@ class RegEx;
 class Scanner {
  public:
   explicit Scanner(std::istream &in);
+  Scanner(const char *data, std::size_t size,
+          MarkMode marks = MarkMode::LineColumn);
+
+  /**
+   * Scans a part of some larger buffer, starting at the start of a line
+   * (see the corresponding {@link Stream} constructor).
+   */
+  Scanner(const char *data, std::size_t size, const Mark &start,
+          char lineEnding);
+
+  /**
+   * Scans input that's pushed to it in chunks (see {@link #Push}). Running
+   * out of it, before its end, throws MoreInputNeeded from whatever needed
+   * the next token; the scanner is then as it was before that token, and
+   * carries on from there once there's more.
+   *
+   * The tokens that are popped are held on to until they're committed, so
+   * that a reader that runs out of input too can go back to where it was
+   * (see {@link #Rewind}).
+   */
+  Scanner();
   ~Scanner();
 
   /** Returns true if there are no more tokens to be read. */
@@ -42,6 +64,47 @@ class Scanner {
   /** Returns the current mark in the input stream. */
   Mark mark() const;
 
+  /**
+   * Returns the number of indentation markers being kept, which is bounded by
+   * the current document (rather than by the whole stream).
+   */
+  std::size_t indentMarkerCount() const { return m_indentRefs.size(); }
+
+  /**
+   * Returns the given mark in full: that is, with its line and column, if
+   * the marks are only offsets.
+   */
+  Mark Locate(const Mark &mark) const { return INPUT.Locate(mark); }
+
+  /**
+   * Skips the value of a block map, just after its ':' token has been
+   * popped, without scanning it into tokens: it's the rest of the line and
+   * any lines after that are blank, or indented more than the map's keys (or
+   * as much, for an indentless sequence). So it isn't checked, either.
+   *
+   * @return false (having skipped nothing) unless the input is read in place
+   *         and nothing has been scanned past the ':'.
+   */
+  bool SkipBlockValue();
+
+  /** Takes the next chunk of pushed input (which is copied). */
+  void Push(const char *data, std::size_t size) { INPUT.Push(data, size); }
+
+  /** Ends the pushed input. */
+  void Close() { INPUT.Close(); }
+
+  /**
+   * Returns how much of the pushed input is being kept: from the start of the
+   * token that's next to be scanned on.
+   */
+  std::size_t pushedSize() const { return INPUT.savedSize(); }
+
+  /** Drops the tokens that have been popped so far. */
+  void Commit() { m_tokens.release(); }
+
+  /** Puts back the tokens that have been popped since the last commit. */
+  void Rewind() { m_tokens.unpop(); }
+
  private:
   struct IndentMarker {
     enum INDENT_TYPE { MAP, SEQ, NONE };
@@ -73,6 +136,12 @@ class Scanner {
    */
   void ScanNextToken();
 
+  /**
+   * Scans the next token of pushed input; if that runs out first, goes back
+   * to where it started, and rethrows MoreInputNeeded.
+   */
+  void ScanNextPushedToken();
+
   /** Eats the input stream until it reaches the next token-like thing. */
   void ScanToNextToken();
 
@@ -113,6 +182,13 @@ class Scanner {
 
   /** Pops a single indent, pushing the proper token. */
   void PopIndent();
+
+  /**
+   * Frees the indentations that have been popped, at a document boundary
+   * (once all of them and all simple keys, which can refer to them, have
+   * been popped).
+   */
+  void ReleasePoppedIndents();
   int GetTopIndent() const;
 
   // checking input
@@ -170,17 +246,37 @@ class Scanner {
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
   bool m_simpleKeyAllowed;
   bool m_scalarValueAllowed;
   bool m_canBeJSONFlow;
-  std::stack<SimpleKey> m_simpleKeys;
-  std::stack<IndentMarker *> m_indents;
-  ptr_vector<IndentMarker> m_indentRefs;  // for "garbage collection"
-  std::stack<FLOW_MARKER> m_flows;
+  std::stack<SimpleKey, std::vector<SimpleKey>> m_simpleKeys;
+  std::stack<IndentMarker *, std::vector<IndentMarker *>> m_indents;
+  std::deque<IndentMarker> m_indentRefs;  // this document's, for "garbage
+                                          // collection"
+  std::stack<FLOW_MARKER, std::vector<FLOW_MARKER>> m_flows;
+
+  // pushed input: the state before the token that's being scanned (where
+  // the statuses are the top simple key's, which is the only one that
+  // scanning a token can change)
+  struct Checkpoint {
+    std::size_t tokens = 0;
+    std::size_t indentRefs = 0;
+    bool startedStream = false, endedStream = false;
+    bool simpleKeyAllowed = false;
+    bool scalarValueAllowed = false;
+    bool canBeJSONFlow = false;
+    std::stack<SimpleKey, std::vector<SimpleKey>> simpleKeys{};
+    std::stack<IndentMarker *, std::vector<IndentMarker *>> indents{};
+    std::stack<FLOW_MARKER, std::vector<FLOW_MARKER>> flows{};
+    IndentMarker::STATUS indentStatus = IndentMarker::VALID;
+    Token::STATUS mapStartStatus = Token::VALID;
+    Token::STATUS keyStatus = Token::VALID;
+  };
+  Checkpoint m_checkpoint;
 };
 }
 
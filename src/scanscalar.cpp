@@ -1,6 +1,8 @@
 #include "scanscalar.h"
 
 #include <algorithm>
+#include <cstring>
+#include <utility>
 
 #include "exp.h"
 #include "regeximpl.h"
@@ -8,6 +10,111 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
+namespace {
+bool IsPlain(char ch, const ScanScalarParams& params) {
+  return ch != Stream::eof() && ch != params.escape &&
+         params.end->CantStartWith(ch) && Exp::Break().CantStartWith(ch);
+}
+
+// The number of characters at the start of the stream's window that can be
+// copied into the scalar as they are: ones that can't start its end, a line
+// break or an escape.
+std::size_t CountPlainRun(const Stream& INPUT, const ScanScalarParams& params) {
+  const char* chars = INPUT.window();
+  const std::size_t size = INPUT.windowSize();
+
+  std::size_t n = 0;
+  while (n < size && IsPlain(chars[n], params))
+    n++;
+  return n;
+}
+
+// The text of a scalar as it's scanned, with the few string operations that
+// ScanScalar needs. While it's only appended to from the input, in order, and
+// the input is read in place, it's just a slice of the input; any other change
+// copies it into a string of its own.
+class ScalarText {
+ public:
+  explicit ScalarText(bool canSlice)
+      : m_sliced(canSlice), m_pSlice(nullptr), m_sliceSize(0), m_str{} {}
+  ScalarText(const ScalarText&) = delete;
+  ScalarText& operator=(const ScalarText&) = delete;
+
+  std::size_t size() const { return m_sliced ? m_sliceSize : m_str.size(); }
+
+  // Appends the next n characters of the input, before it moves past them.
+  void AppendInput(const char* chars, std::size_t n) {
+    if (m_sliced) {
+      if (m_sliceSize == 0)
+        m_pSlice = chars;
+      if (chars == m_pSlice + m_sliceSize) {
+        m_sliceSize += n;
+        return;
+      }
+      Unslice();
+    }
+    m_str.append(chars, n);
+  }
+
+  ScalarText& operator+=(const std::string& str) {
+    if (!str.empty()) {
+      Unslice();
+      m_str += str;
+    }
+    return *this;
+  }
+  ScalarText& operator+=(const char* str) { return *this += std::string(str); }
+
+  void erase(std::size_t pos = 0) {
+    if (m_sliced)
+      m_sliceSize = std::min(pos, m_sliceSize);
+    else if (pos < m_str.size())
+      m_str.erase(pos);
+  }
+
+  std::size_t find_last_not_of(const char* chars) const {
+    const StringRef text = Text();
+    for (std::size_t i = text.size(); i > 0; i--) {
+      if (!std::strchr(chars, text[i - 1]))
+        return i - 1;
+    }
+    return std::string::npos;
+  }
+  std::size_t find_last_not_of(char ch) const {
+    const char chars[] = {ch, 0};
+    return find_last_not_of(chars);
+  }
+
+  void MoveTo(Token& token) {
+    if (m_sliced) {
+      token.slice = Text();
+      token.sliced = true;
+    } else {
+      token.value = std::move(m_str);
+    }
+  }
+
+ private:
+  StringRef Text() const {
+    return m_sliced ? StringRef(m_pSlice ? m_pSlice : "", m_sliceSize)
+                    : StringRef(m_str);
+  }
+
+  void Unslice() {
+    if (!m_sliced)
+      return;
+    if (m_pSlice)
+      m_str.assign(m_pSlice, m_sliceSize);
+    m_sliced = false;
+  }
+
+  bool m_sliced;
+  const char* m_pSlice;
+  std::size_t m_sliceSize;
+  std::string m_str;
+};
+}  // namespace
+
 // ScanScalar
 // . This is where the scalar magic happens.
 //
@@ -18,14 +125,14 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, Token& token) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  ScalarText scalar(INPUT.readsInPlace());
   params.leadingSpaces = false;
 
   if (!params.end) {
@@ -75,11 +182,26 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       }
 
       // otherwise, just add the damn character
+      scalar.AppendInput(INPUT.window(), 1);
       char ch = INPUT.get();
-      scalar += ch;
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
+
+      // and the run of plain characters after it, all at once (after the
+      // first, none can be at the start of a line)
+      const std::size_t run = CountPlainRun(INPUT, params);
+      if (run > 0) {
+        const char* chars = INPUT.window();
+        scalar.AppendInput(chars, run);
+        for (std::size_t i = run; i > 0; i--) {
+          if (chars[i - 1] != ' ' && chars[i - 1] != '\t') {
+            lastNonWhitespaceChar = scalar.size() - run + i;
+            break;
+          }
+        }
+        INPUT.eatInLine(run);
+      }
     }
 
     // eof? if we're looking to eat something, then we throw
@@ -246,6 +368,6 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       break;
   }
 
-  return scalar;
+  scalar.MoveTo(token);
 }
 }  // namespace YAML
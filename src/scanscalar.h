@@ -11,6 +11,7 @@
 
 #include "regex_yaml.h"
 #include "stream.h"
+#include "token.h"
 
 namespace YAML {
 enum CHOMP { STRIP = -1, CLIP, KEEP };
@@ -57,7 +58,9 @@ struct ScanScalarParams {
   bool leadingSpaces;
 };
 
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params);
+// Scans a scalar into the token, as its value or (if it can) a slice of the
+// input.
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, Token& token);
 }
 
 #endif  // SCANSCALAR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
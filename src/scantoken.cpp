@@ -1,4 +1,5 @@
 #include <sstream>
+#include <utility>
 
 #include "exp.h"
 #include "regex_yaml.h"
@@ -54,7 +55,11 @@ void Scanner::ScanDirective() {
     token.params.push_back(param);
   }
 
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
+
+  // (only once it's been scanned: pushed input can run out before then, and
+  // the scanner then goes back to before the indents were popped)
+  ReleasePoppedIndents();
 }
 
 // DocStart
@@ -68,6 +73,7 @@ void Scanner::ScanDocStart() {
   Mark mark = INPUT.mark();
   INPUT.eat(3);
   m_tokens.push(Token(Token::DOC_START, mark));
+  ReleasePoppedIndents();  // (as for a directive)
 }
 
 // DocEnd
@@ -81,6 +87,7 @@ void Scanner::ScanDocEnd() {
   Mark mark = INPUT.mark();
   INPUT.eat(3);
   m_tokens.push(Token(Token::DOC_END, mark));
+  ReleasePoppedIndents();  // (as for a directive)
 }
 
 // FlowStart
@@ -252,7 +259,7 @@ void Scanner::ScanAnchorOrAlias() {
   // and we're done
   Token token(alias ? Token::ALIAS : Token::ANCHOR, mark);
   token.value = name;
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
 }
 
 // Tag
@@ -291,13 +298,11 @@ void Scanner::ScanTag() {
     }
   }
 
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
 }
 
 // PlainScalar
 void Scanner::ScanPlainScalar() {
-  std::string scalar;
-
   // set up the scanning parameters
   ScanScalarParams params;
   params.end =
@@ -314,8 +319,8 @@ void Scanner::ScanPlainScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
-  scalar = ScanScalar(INPUT, params);
+  Token token(Token::PLAIN_SCALAR, INPUT.mark());
+  ScanScalar(INPUT, params, token);
 
   // can have a simple key only if we ended the scalar by starting a new line
   m_simpleKeyAllowed = params.leadingSpaces;
@@ -325,15 +330,11 @@ void Scanner::ScanPlainScalar() {
   // if(Exp::IllegalCharInScalar.Matches(INPUT))
   //	throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_SCALAR);
 
-  Token token(Token::PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
 }
 
 // QuotedScalar
 void Scanner::ScanQuotedScalar() {
-  std::string scalar;
-
   // peek at single or double quote (don't eat because we need to preserve (for
   // the time being) the input position)
   char quote = INPUT.peek();
@@ -341,8 +342,7 @@ void Scanner::ScanQuotedScalar() {
 
   // setup the scanning parameters
   ScanScalarParams params;
-  RegEx end = (single ? RegEx(quote) & !Exp::EscSingleQuote() : RegEx(quote));
-  params.end = &end;
+  params.end = (single ? &Exp::EndSingleQuoted() : &Exp::EndDoubleQuoted());
   params.eatEnd = true;
   params.escape = (single ? '\'' : '\\');
   params.indent = 0;
@@ -355,13 +355,13 @@ void Scanner::ScanQuotedScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
+  Token token(Token::NON_PLAIN_SCALAR, INPUT.mark());
 
   // now eat that opening quote
   INPUT.get();
 
   // and scan
-  scalar = ScanScalar(INPUT, params);
+  ScanScalar(INPUT, params, token);
   m_simpleKeyAllowed = false;
   // we just scanned a quoted scalar;
   // we can only have another scalar in this line
@@ -369,9 +369,7 @@ void Scanner::ScanQuotedScalar() {
   m_scalarValueAllowed = InFlowContext();
   m_canBeJSONFlow = true;
 
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
 }
 
 // BlockScalarToken
@@ -380,14 +378,12 @@ void Scanner::ScanQuotedScalar() {
 // of the scalar),
 //   and then we need to figure out what level of indentation we'll be using.
 void Scanner::ScanBlockScalar() {
-  std::string scalar;
-
   ScanScalarParams params;
   params.indent = 1;
   params.detectIndent = true;
 
   // eat block indicator ('|' or '>')
-  Mark mark = INPUT.mark();
+  Token token(Token::NON_PLAIN_SCALAR, INPUT.mark());
   char indicator = INPUT.get();
   params.fold = (indicator == Keys::FoldedScalar ? FOLD_BLOCK : DONT_FOLD);
 
@@ -430,15 +426,13 @@ void Scanner::ScanBlockScalar() {
   params.trimTrailingSpaces = false;
   params.onTabInIndentation = THROW;
 
-  scalar = ScanScalar(INPUT, params);
+  ScanScalar(INPUT, params, token);
 
   // simple keys always ok after block scalars (since we're gonna start a new
   // line anyways)
   m_simpleKeyAllowed = true;
   m_canBeJSONFlow = false;
 
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.push(std::move(token));
 }
 }  // namespace YAML
@@ -112,8 +112,10 @@ bool Scanner::VerifySimpleKey() {
 
   bool isValid = true;
 
-  // needs to be less than 1024 characters and inline
-  if (INPUT.line() != key.mark.line || INPUT.pos() - key.mark.pos > 1024)
+  // needs to be less than 1024 characters and inline (i.e., starting no
+  // earlier than this line does)
+  if (key.mark.pos < INPUT.pos() - INPUT.column() ||
+      INPUT.pos() - key.mark.pos > 1024)
     isValid = false;
 
   // invalidate key
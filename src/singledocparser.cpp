@@ -1,7 +1,8 @@
+#include <cassert>
 #include <cstdio>
 #include <sstream>
+#include <utility>
 
-#include "collectionstack.h"  // IWYU pragma: keep
 #include "scanner.h"
 #include "singledocparser.h"
 #include "tag.h"
@@ -9,37 +10,178 @@
 #include "yaml-cpp/depthguard.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/eventreader.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/mark.h"
 #include "yaml-cpp/null.h"
+#include "yaml-cpp/refeventhandler.h"
 
 namespace YAML {
-SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives)
+SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives,
+                                 const KeyFilter* filter)
     : m_scanner(scanner),
       m_directives(directives),
-      m_pCollectionStack(new CollectionStack),
+      m_pFilter(filter),
+      m_frames{},
+      m_nodeNext(false),
+      m_savedFrames{},
+      m_savedNodeNext(false),
+      m_savedCurAnchor(0),
+      m_tag{},
+      m_value{},
+      m_anchorName{},
       m_anchors{},
-      m_curAnchor(0) {}
+      m_curAnchor(0) {
+  m_frames.emplace_back(CollectionType::NoCollection, Frame::START,
+                        filter ? filter->root() : KeyFilter::All);
+}
 
 SingleDocParser::~SingleDocParser() = default;
 
+namespace {
+// Sends the event to the handler, with the given strings standing in for its
+// own (which are only references).
+template <typename Handler, typename String>
+void SendEvent(Handler& handler, const Event& event, const String& tag,
+               const String& value, const String& anchorName) {
+  if (!event.anchorName.empty() && event.type != Event::Alias)
+    handler.OnAnchor(event.mark, anchorName);
+
+  switch (event.type) {
+    case Event::DocumentStart:
+      handler.OnDocumentStart(event.mark);
+      break;
+    case Event::DocumentEnd:
+      handler.OnDocumentEnd();
+      break;
+    case Event::Null:
+      handler.OnNull(event.mark, event.anchor);
+      break;
+    case Event::Alias:
+      handler.OnAlias(event.mark, event.anchor);
+      break;
+    case Event::Scalar:
+      handler.OnScalar(event.mark, tag, event.anchor, value);
+      break;
+    case Event::SequenceStart:
+      handler.OnSequenceStart(event.mark, tag, event.anchor, event.style);
+      break;
+    case Event::SequenceEnd:
+      handler.OnSequenceEnd();
+      break;
+    case Event::MapStart:
+      handler.OnMapStart(event.mark, tag, event.anchor, event.style);
+      break;
+    case Event::MapEnd:
+      handler.OnMapEnd();
+      break;
+  }
+}
+}  // namespace
+
 // HandleDocument
 // . Handles the next document
 // . Throws a ParserException on error.
 void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
-  assert(!m_scanner.empty());  // guaranteed that there are tokens
-  assert(!m_curAnchor);
+  Event event;
+  while (HandleNextEvent(event))
+    HandleEvent(eventHandler, event);
+}
 
-  eventHandler.OnDocumentStart(m_scanner.peek().mark);
+void SingleDocParser::HandleDocument(RefEventHandler& eventHandler) {
+  Event event;
+  while (HandleNextEvent(event))
+    SendEvent(eventHandler, event, event.tag, event.value, event.anchorName);
+}
 
-  // eat doc start
-  if (m_scanner.peek().type == Token::DOC_START)
-    m_scanner.pop();
+void SingleDocParser::HandleEvent(EventHandler& eventHandler,
+                                  const Event& event) {
+  // the handler takes strings, so a slice of the input is copied (into the
+  // same string each time)
+  if (event.value.data() != m_value.data())
+    m_value.assign(event.value.data(), event.value.size());
+  SendEvent(eventHandler, event, m_tag, m_value, m_anchorName);
+}
 
-  // recurse!
-  HandleNode(eventHandler);
+void SingleDocParser::Save() {
+  m_savedFrames = m_frames;
+  m_savedNodeNext = m_nodeNext;
+  m_savedCurAnchor = m_curAnchor;
+}
 
-  eventHandler.OnDocumentEnd();
+void SingleDocParser::Restore() {
+  m_frames = m_savedFrames;
+  m_nodeNext = m_savedNodeNext;
+  m_curAnchor = m_savedCurAnchor;
+}
+
+bool SingleDocParser::HandleNextEvent(Event& event) {
+  event = Event();
+
+  while (!m_frames.empty()) {
+    if (m_nodeNext) {
+      m_nodeNext = false;
+      HandleNode(event);
+      return true;
+    }
+
+    Frame& frame = m_frames.back();
+    bool handled = false;
+    switch (frame.type) {
+      case CollectionType::NoCollection:
+        handled = HandleDocumentFrame(frame, event);
+        break;
+      case CollectionType::BlockSeq:
+        handled = HandleBlockSequence(frame, event);
+        break;
+      case CollectionType::FlowSeq:
+        handled = HandleFlowSequence(frame, event);
+        break;
+      case CollectionType::BlockMap:
+        handled = HandleBlockMap(frame, event);
+        break;
+      case CollectionType::FlowMap:
+        handled = HandleFlowMap(frame, event);
+        break;
+      case CollectionType::CompactMap:
+        handled = HandleCompactMap(frame, event);
+        break;
+    }
+
+    if (handled)
+      return true;
+  }
+
+  return false;
+}
+
+bool SingleDocParser::HandleDocumentFrame(Frame& frame, Event& event) {
+  switch (frame.state) {
+    case Frame::START:
+      assert(!m_scanner.empty());  // guaranteed that there are tokens
+      assert(!m_curAnchor);
+
+      event.type = Event::DocumentStart;
+      event.mark = m_scanner.peek().mark;
+
+      // eat doc start
+      if (m_scanner.peek().type == Token::DOC_START)
+        m_scanner.pop();
+
+      frame.state = Frame::VALUE;
+      return true;
+    case Frame::VALUE:
+      frame.state = Frame::END;
+      m_nodeNext = true;
+      return false;
+    case Frame::END:
+      event.type = Event::DocumentEnd;
+      event.mark = m_scanner.mark();
+      frame.state = Frame::DONE;
+      return true;
+    default:
+      break;
+  }
 
   // check if any tokens left after the text
   if (!m_scanner.empty() && m_scanner.peek().type != Token::DOC_END
@@ -49,14 +191,19 @@ void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
   // and finally eat any doc ends we see
   if (!m_scanner.empty() && m_scanner.peek().type == Token::DOC_END)
     m_scanner.pop();
+
+  m_frames.pop_back();
+  return false;
 }
 
-void SingleDocParser::HandleNode(EventHandler& eventHandler) {
+void SingleDocParser::HandleNode(Event& event) {
+  // each open collection is one more level of nesting
+  int depth = static_cast<int>(m_frames.size()) - 1;
   DepthGuard<500> depthguard(depth, m_scanner.mark(), ErrorMsg::BAD_FILE);
 
   // an empty node *is* a possibility
   if (m_scanner.empty()) {
-    eventHandler.OnNull(m_scanner.mark(), NullAnchor);
+    SetNull(event, m_scanner.mark(), NullAnchor);
     return;
   }
 
@@ -65,80 +212,99 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
 
   // special case: a value node by itself must be a map, with no header
   if (m_scanner.peek().type == Token::VALUE) {
-    eventHandler.OnMapStart(mark, "?", NullAnchor, EmitterStyle::Default);
-    HandleMap(eventHandler);
-    eventHandler.OnMapEnd();
+    m_tag = "?";
+    event.type = Event::MapStart;
+    event.mark = mark;
+    event.tag = m_tag;
+    PushCollection(CollectionType::CompactMap, Frame::NULL_KEY);
     return;
   }
 
   // special case: an alias node
   if (m_scanner.peek().type == Token::ALIAS) {
-    eventHandler.OnAlias(mark, LookupAnchor(mark, m_scanner.peek().value));
+    Token& token = m_scanner.peek();
+    event.type = Event::Alias;
+    event.mark = mark;
+    event.anchor = LookupAnchor(mark, token.value);
+    m_anchorName = std::move(token.value);
+    event.anchorName = m_anchorName;
     m_scanner.pop();
     return;
   }
 
-  std::string tag;
-  std::string anchor_name;
   anchor_t anchor;
-  ParseProperties(tag, anchor, anchor_name);
+  ParseProperties(m_tag, anchor, m_anchorName);
 
-  if (!anchor_name.empty())
-    eventHandler.OnAnchor(mark, anchor_name);
+  if (!m_anchorName.empty())
+    event.anchorName = m_anchorName;
 
   // after parsing properties, an empty node is again a possibility
   if (m_scanner.empty()) {
-    eventHandler.OnNull(mark, anchor);
+    SetNull(event, mark, anchor);
     return;
   }
 
-  const Token& token = m_scanner.peek();
+  Token& token = m_scanner.peek();
 
   // add non-specific tags
-  if (tag.empty())
-    tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
+  if (m_tag.empty())
+    m_tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
 
+  const StringRef text = token.text();
   if (token.type == Token::PLAIN_SCALAR
-      && tag == "?" && IsNullString(token.value.data(), token.value.size())) {
-    eventHandler.OnNull(mark, anchor);
+      && m_tag == "?" && IsNullString(text.data(), text.size())) {
+    SetNull(event, mark, anchor);
     m_scanner.pop();
     return;
   }
 
+  event.mark = mark;
+  event.tag = m_tag;
+  event.anchor = anchor;
+
   // now split based on what kind of node we should be
   switch (token.type) {
     case Token::PLAIN_SCALAR:
     case Token::NON_PLAIN_SCALAR:
-      eventHandler.OnScalar(mark, tag, anchor, token.value);
+      event.type = Event::Scalar;
+      if (token.sliced) {
+        event.value = token.slice;
+      } else {
+        m_value = std::move(token.value);
+        event.value = m_value;
+      }
       m_scanner.pop();
       return;
     case Token::FLOW_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      event.type = Event::SequenceStart;
+      event.style = EmitterStyle::Flow;
+      m_scanner.pop();
+      PushCollection(CollectionType::FlowSeq, Frame::START);
       return;
     case Token::BLOCK_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      event.type = Event::SequenceStart;
+      event.style = EmitterStyle::Block;
+      m_scanner.pop();
+      PushCollection(CollectionType::BlockSeq, Frame::START);
       return;
     case Token::FLOW_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      event.type = Event::MapStart;
+      event.style = EmitterStyle::Flow;
+      m_scanner.pop();
+      PushCollection(CollectionType::FlowMap, Frame::KEY);
       return;
     case Token::BLOCK_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      event.type = Event::MapStart;
+      event.style = EmitterStyle::Block;
+      m_scanner.pop();
+      PushCollection(CollectionType::BlockMap, Frame::KEY);
       return;
     case Token::KEY:
       // compact maps can only go in a flow sequence
-      if (m_pCollectionStack->GetCurCollectionType() ==
-          CollectionType::FlowSeq) {
-        eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-        HandleMap(eventHandler);
-        eventHandler.OnMapEnd();
+      if (m_frames.back().type == CollectionType::FlowSeq) {
+        event.type = Event::MapStart;
+        event.style = EmitterStyle::Flow;
+        PushCollection(CollectionType::CompactMap, Frame::KEY);
         return;
       }
       break;
@@ -146,231 +312,328 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
       break;
   }
 
-  if (tag == "?")
-    eventHandler.OnNull(mark, anchor);
-  else
-    eventHandler.OnScalar(mark, tag, anchor, "");
-}
-
-void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_SEQ_START:
-      HandleBlockSequence(eventHandler);
-      break;
-    case Token::FLOW_SEQ_START:
-      HandleFlowSequence(eventHandler);
-      break;
-    default:
-      break;
+  if (m_tag == "?") {
+    SetNull(event, mark, anchor);
+  } else {
+    event.type = Event::Scalar;
+    m_value.clear();
+    event.value = m_value;
   }
 }
 
-void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
+bool SingleDocParser::HandleBlockSequence(Frame& /*frame*/, Event& event) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
 
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
-
-    Token token = m_scanner.peek();
-    if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
+  Token& token = m_scanner.peek();
+  if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
 
-    m_scanner.pop();
-    if (token.type == Token::BLOCK_SEQ_END)
-      break;
+  const Token::TYPE type = token.type;
+  const Mark mark = token.mark;
+  m_scanner.pop();
+  if (type == Token::BLOCK_SEQ_END) {
+    PopCollection(event, mark);
+    return true;
+  }
 
-    // check for null
-    if (!m_scanner.empty()) {
-      const Token& nextToken = m_scanner.peek();
-      if (nextToken.type == Token::BLOCK_ENTRY ||
-          nextToken.type == Token::BLOCK_SEQ_END) {
-        eventHandler.OnNull(nextToken.mark, NullAnchor);
-        continue;
-      }
+  // check for null
+  if (!m_scanner.empty()) {
+    const Token& nextToken = m_scanner.peek();
+    if (nextToken.type == Token::BLOCK_ENTRY ||
+        nextToken.type == Token::BLOCK_SEQ_END) {
+      SetNull(event, nextToken.mark, NullAnchor);
+      return true;
     }
-
-    HandleNode(eventHandler);
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
+  m_nodeNext = true;
+  return false;
 }
 
-void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
-
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+bool SingleDocParser::HandleFlowSequence(Frame& frame, Event& event) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
+  if (frame.state == Frame::START) {
     // first check for end
     if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
+      const Mark mark = m_scanner.peek().mark;
       m_scanner.pop();
-      break;
+      PopCollection(event, mark);
+      return true;
     }
 
     // then read the node
-    HandleNode(eventHandler);
-
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
-
-    // now eat the separator (or could be a sequence end, which we ignore - but
-    // if it's neither, then it's a bad node)
-    Token& token = m_scanner.peek();
-    if (token.type == Token::FLOW_ENTRY)
-      m_scanner.pop();
-    else if (token.type != Token::FLOW_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
+    frame.state = Frame::SEPARATOR;
+    m_nodeNext = true;
+    return false;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
-}
+  // now eat the separator (or could be a sequence end, which we ignore - but
+  // if it's neither, then it's a bad node)
+  Token& token = m_scanner.peek();
+  if (token.type == Token::FLOW_ENTRY)
+    m_scanner.pop();
+  else if (token.type != Token::FLOW_SEQ_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
 
-void SingleDocParser::HandleMap(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_MAP_START:
-      HandleBlockMap(eventHandler);
-      break;
-    case Token::FLOW_MAP_START:
-      HandleFlowMap(eventHandler);
-      break;
-    case Token::KEY:
-      HandleCompactMap(eventHandler);
-      break;
-    case Token::VALUE:
-      HandleCompactMapWithNoKey(eventHandler);
-      break;
-    default:
-      break;
-  }
+  frame.state = Frame::START;
+  return false;
 }
 
-void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
-
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
-
-    Token token = m_scanner.peek();
-    if (token.type != Token::KEY && token.type != Token::VALUE &&
-        token.type != Token::BLOCK_MAP_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
-
-    if (token.type == Token::BLOCK_MAP_END) {
-      m_scanner.pop();
-      break;
-    }
-
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
-    }
-
+bool SingleDocParser::HandleBlockMap(Frame& frame, Event& event) {
+  if (frame.state == Frame::VALUE) {
     // now grab value (optional)
+    frame.state = Frame::KEY;
     if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
       m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
+      m_nodeNext = true;
+      return false;
     }
+    SetNull(event, frame.mark, NullAnchor);
+    return true;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
+
+  Token& token = m_scanner.peek();
+  if (token.type != Token::KEY && token.type != Token::VALUE &&
+      token.type != Token::BLOCK_MAP_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
+
+  if (token.type == Token::BLOCK_MAP_END) {
+    const Mark mark = token.mark;
+    m_scanner.pop();
+    PopCollection(event, mark);
+    return true;
+  }
+
+  // grab key (if non-null)
+  const bool hasKey = token.type == Token::KEY;
+  frame.mark = token.mark;
+  if (hasKey)
+    m_scanner.pop();
+  if (!KeepEntry(frame, hasKey))
+    return false;
+
+  frame.state = Frame::VALUE;
+  if (hasKey) {
+    m_nodeNext = true;
+    return false;
+  }
+  SetNull(event, frame.mark, NullAnchor);
+  return true;
 }
 
-void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
+bool SingleDocParser::HandleFlowMap(Frame& frame, Event& event) {
+  switch (frame.state) {
+    case Frame::KEY: {
+      if (m_scanner.empty())
+        throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+
+      Token& token = m_scanner.peek();
+      // first check for end
+      if (token.type == Token::FLOW_MAP_END) {
+        const Mark mark = token.mark;
+        m_scanner.pop();
+        PopCollection(event, mark);
+        return true;
+      }
 
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+      // grab key (if non-null)
+      const bool hasKey = token.type == Token::KEY;
+      frame.mark = token.mark;
+      if (hasKey)
+        m_scanner.pop();
+      if (!KeepEntry(frame, hasKey)) {
+        frame.state = Frame::SEPARATOR;
+        return false;
+      }
 
-    Token& token = m_scanner.peek();
-    const Mark mark = token.mark;
-    // first check for end
-    if (token.type == Token::FLOW_MAP_END) {
-      m_scanner.pop();
-      break;
+      frame.state = Frame::VALUE;
+      if (hasKey) {
+        m_nodeNext = true;
+        return false;
+      }
+      SetNull(event, frame.mark, NullAnchor);
+      return true;
     }
+    case Frame::VALUE:
+      // now grab value (optional)
+      frame.state = Frame::SEPARATOR;
+      if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+        m_scanner.pop();
+        m_nodeNext = true;
+        return false;
+      }
+      SetNull(event, frame.mark, NullAnchor);
+      return true;
+    default:
+      break;
+  }
 
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
-    // now grab value (optional)
-    if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
+  // now eat the separator (or could be a map end, which we ignore - but if
+  // it's neither, then it's a bad node)
+  Token& nextToken = m_scanner.peek();
+  if (nextToken.type == Token::FLOW_ENTRY)
+    m_scanner.pop();
+  else if (nextToken.type != Token::FLOW_MAP_END)
+    throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
 
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+  frame.state = Frame::KEY;
+  return false;
+}
 
-    // now eat the separator (or could be a map end, which we ignore - but if
-    // it's neither, then it's a bad node)
-    Token& nextToken = m_scanner.peek();
-    if (nextToken.type == Token::FLOW_ENTRY)
+// . Single "key: value" pair in a flow sequence (or ": value", with a null
+//   key)
+bool SingleDocParser::HandleCompactMap(Frame& frame, Event& event) {
+  switch (frame.state) {
+    case Frame::KEY:
+      // grab key
+      frame.mark = m_scanner.peek().mark;
+      frame.state = Frame::VALUE;
       m_scanner.pop();
-    else if (nextToken.type != Token::FLOW_MAP_END)
-      throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
+      if (!KeepEntry(frame, true)) {
+        frame.state = Frame::DONE;
+        return false;
+      }
+      m_nodeNext = true;
+      return false;
+    case Frame::NULL_KEY:
+      frame.mark = m_scanner.peek().mark;
+      frame.state = Frame::VALUE;
+      if (!KeepEntry(frame, false)) {
+        frame.state = Frame::DONE;
+        return false;
+      }
+      SetNull(event, frame.mark, NullAnchor);
+      return true;
+    case Frame::VALUE:
+      // now grab value (optional)
+      frame.state = Frame::DONE;
+      if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+        m_scanner.pop();
+        m_nodeNext = true;
+        return false;
+      }
+      SetNull(event, frame.mark, NullAnchor);
+      return true;
+    default:
+      PopCollection(event, m_scanner.mark());
+      return true;
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowMap);
 }
 
-// . Single "key: value" pair in a flow sequence
-void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // grab key
-  Mark mark = m_scanner.peek().mark;
-  m_scanner.pop();
-  HandleNode(eventHandler);
+bool SingleDocParser::KeepEntry(Frame& frame, bool hasKey) {
+  if (frame.filter == KeyFilter::All)
+    return true;
+
+  // only a scalar key (with no properties) can be on a path
+  if (hasKey && !m_scanner.empty()) {
+    const Token& token = m_scanner.peek();
+    if ((token.type == Token::PLAIN_SCALAR ||
+         token.type == Token::NON_PLAIN_SCALAR) &&
+        m_pFilter->Find(frame.filter, token.text(), frame.nodeFilter))
+      return true;
+  }
 
-  // now grab value (optional)
+  if (hasKey)
+    SkipNode();
   if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
     m_scanner.pop();
-    HandleNode(eventHandler);
-  } else {
-    eventHandler.OnNull(mark, NullAnchor);
+    // a block map's value needn't even be scanned into tokens
+    if (frame.type != CollectionType::BlockMap || !m_scanner.SkipBlockValue())
+      SkipNode();
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+  return false;
 }
 
-// . Single ": value" pair in a flow sequence
-void SingleDocParser::HandleCompactMapWithNoKey(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
+// SkipNode
+// . Pops the tokens of the next node, without any events. Its anchor (if
+//   any) isn't registered, so an alias can't refer to it.
+void SingleDocParser::SkipNode() {
+  while (!m_scanner.empty() && (m_scanner.peek().type == Token::TAG ||
+                                m_scanner.peek().type == Token::ANCHOR))
+    m_scanner.pop();
+  if (m_scanner.empty())
+    return;
 
-  // null key
-  eventHandler.OnNull(m_scanner.peek().mark, NullAnchor);
+  const Token::TYPE start = m_scanner.peek().type;
+  switch (start) {
+    case Token::PLAIN_SCALAR:
+    case Token::NON_PLAIN_SCALAR:
+    case Token::ALIAS:
+      m_scanner.pop();
+      return;
+    case Token::FLOW_SEQ_START:
+    case Token::FLOW_MAP_START:
+    case Token::BLOCK_SEQ_START:
+    case Token::BLOCK_MAP_START:
+      break;
+    default:
+      return;  // an empty node
+  }
 
-  // grab value
-  m_scanner.pop();
-  HandleNode(eventHandler);
+  // a collection runs up to the end that matches its start
+  int depth = 0;
+  do {
+    // (only a flow collection can be left open)
+    if (m_scanner.empty())
+      throw ParserException(m_scanner.mark(),
+                            start == Token::FLOW_SEQ_START
+                                ? ErrorMsg::END_OF_SEQ_FLOW
+                                : ErrorMsg::END_OF_MAP_FLOW);
+
+    switch (m_scanner.peek().type) {
+      case Token::FLOW_SEQ_START:
+      case Token::FLOW_MAP_START:
+      case Token::BLOCK_SEQ_START:
+      case Token::BLOCK_MAP_START:
+        depth++;
+        break;
+      case Token::FLOW_SEQ_END:
+      case Token::FLOW_MAP_END:
+      case Token::BLOCK_SEQ_END:
+      case Token::BLOCK_MAP_END:
+        depth--;
+        break;
+      default:
+        break;
+    }
+    m_scanner.pop();
+  } while (depth > 0);
+}
+
+void SingleDocParser::PushCollection(CollectionType::value type,
+                                     Frame::State state) {
+  const KeyFilter::State filter = m_frames.back().nodeFilter;
+  m_frames.emplace_back(type, state, filter);
+}
+
+void SingleDocParser::PopCollection(Event& event, const Mark& mark) {
+  switch (m_frames.back().type) {
+    case CollectionType::BlockSeq:
+    case CollectionType::FlowSeq:
+      event.type = Event::SequenceEnd;
+      break;
+    default:
+      event.type = Event::MapEnd;
+      break;
+  }
+  event.mark = mark;
+  m_frames.pop_back();
+}
 
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+void SingleDocParser::SetNull(Event& event, const Mark& mark,
+                              anchor_t anchor) {
+  event.type = Event::Null;
+  event.mark = mark;
+  event.anchor = anchor;
 }
 
 // ParseProperties
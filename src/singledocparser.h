@@ -8,24 +8,36 @@
 #endif
 
 #include <map>
-#include <memory>
 #include <string>
+#include <vector>
 
+#include "collectionstack.h"
+#include "keyfilter.h"
 #include "yaml-cpp/anchor.h"
+#include "yaml-cpp/mark.h"
 
 namespace YAML {
-class CollectionStack;
-template <int> class DepthGuard; // depthguard.h
 class EventHandler;
 class Node;
+class RefEventHandler;
 class Scanner;
 struct Directives;
-struct Mark;
+struct Event;
 struct Token;
 
+/**
+ * Parses a single document, one event at a time.
+ *
+ * Rather than recursing into each collection, it keeps a stack of the open
+ * ones (along with where it is in each), so that it can stop after any event.
+ */
 class SingleDocParser {
  public:
-  SingleDocParser(Scanner& scanner, const Directives& directives);
+  // With a filter, only what's on its key paths is handled: a map keeps just
+  // the entries whose keys are next on some path, and the rest are skipped
+  // without any events (or checks).
+  SingleDocParser(Scanner& scanner, const Directives& directives,
+                  const KeyFilter* filter = nullptr);
   SingleDocParser(const SingleDocParser&) = delete;
   SingleDocParser(SingleDocParser&&) = delete;
   SingleDocParser& operator=(const SingleDocParser&) = delete;
@@ -33,19 +45,64 @@ class SingleDocParser {
   ~SingleDocParser();
 
   void HandleDocument(EventHandler& eventHandler);
+  void HandleDocument(RefEventHandler& eventHandler);
+
+  /**
+   * Reads the next event of the document into {@code event}, whose strings
+   * are valid until the next call.
+   *
+   * @return false after the end of the document
+   */
+  bool HandleNextEvent(Event& event);
+
+  /** Sends an event from {@link #HandleNextEvent} to the event handler. */
+  void HandleEvent(EventHandler& eventHandler, const Event& event);
+
+  /**
+   * Saves where it is in the document, or goes back there: for when the
+   * scanner runs out of pushed input (see {@link Scanner#Rewind}).
+   */
+  void Save();
+  void Restore();
 
  private:
-  void HandleNode(EventHandler& eventHandler);
+  struct Frame {
+    enum State { START, KEY, NULL_KEY, VALUE, SEPARATOR, END, DONE };
+
+    Frame(CollectionType::value type_, State state_,
+          KeyFilter::State filter_)
+        : type(type_),
+          state(state_),
+          mark(),
+          filter(filter_),
+          nodeFilter(filter_) {}
+
+    CollectionType::value type;  // NoCollection for the document itself
+    State state;
+    Mark mark;
+    KeyFilter::State filter;      // what the keys of a map are looked up in
+    KeyFilter::State nodeFilter;  // what the node being read gets
+  };
 
-  void HandleSequence(EventHandler& eventHandler);
-  void HandleBlockSequence(EventHandler& eventHandler);
-  void HandleFlowSequence(EventHandler& eventHandler);
+  // Each of these advances through the given (innermost) frame, and returns
+  // true if that produced an event.
+  bool HandleDocumentFrame(Frame& frame, Event& event);
+  bool HandleBlockSequence(Frame& frame, Event& event);
+  bool HandleFlowSequence(Frame& frame, Event& event);
+  bool HandleBlockMap(Frame& frame, Event& event);
+  bool HandleFlowMap(Frame& frame, Event& event);
+  bool HandleCompactMap(Frame& frame, Event& event);
 
-  void HandleMap(EventHandler& eventHandler);
-  void HandleBlockMap(EventHandler& eventHandler);
-  void HandleFlowMap(EventHandler& eventHandler);
-  void HandleCompactMap(EventHandler& eventHandler);
-  void HandleCompactMapWithNoKey(EventHandler& eventHandler);
+  void HandleNode(Event& event);
+
+  // Returns true if the map entry that's next (after its KEY token, if it has
+  // one) is on the filter's paths; otherwise skips all of it.
+  bool KeepEntry(Frame& frame, bool hasKey);
+  void SkipNode();
+
+  void PushCollection(CollectionType::value type, Frame::State state);
+  void PopCollection(Event& event, const Mark& mark);
+  void SetNull(Event& event, const Mark& mark, anchor_t anchor);
 
   void ParseProperties(std::string& tag, anchor_t& anchor,
                        std::string& anchor_name);
@@ -56,10 +113,21 @@ class SingleDocParser {
   anchor_t LookupAnchor(const Mark& mark, const std::string& name) const;
 
  private:
-  int depth = 0;
   Scanner& m_scanner;
   const Directives& m_directives;
-  std::unique_ptr<CollectionStack> m_pCollectionStack;
+  const KeyFilter* m_pFilter;
+  std::vector<Frame> m_frames;
+  bool m_nodeNext;  // the next event starts a node
+
+  // what Save saved
+  std::vector<Frame> m_savedFrames;
+  bool m_savedNodeNext;
+  anchor_t m_savedCurAnchor;
+
+  // the strings of the current event
+  std::string m_tag;
+  std::string m_value;
+  std::string m_anchorName;
 
   using Anchors = std::map<std::string, anchor_t>;
   Anchors m_anchors;
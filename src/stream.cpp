@@ -1,7 +1,15 @@
+#include <algorithm>
+#include <cstring>
 #include <istream>
 
 #include "stream.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YAML_STREAM_SSE2
+#endif
+
 #ifndef YAML_PREFETCH_SIZE
 #define YAML_PREFETCH_SIZE 2048
 #endif
@@ -158,7 +166,7 @@ inline char Utf8Adjust(unsigned long ch, unsigned char lead_bits,
       static_cast<unsigned char>(header | ((ch >> rshift) & mask)));
 }
 
-inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
+inline char* WriteUnicodeCodepoint(char* out, unsigned long ch) {
   // We are not allowed to queue the Stream::eof() codepoint, so
   // replace it with CP_REPLACEMENT_CHARACTER
   if (static_cast<unsigned long>(Stream::eof()) == ch) {
@@ -166,30 +174,251 @@ inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
   }
 
   if (ch < 0x80) {
-    q.push_back(Utf8Adjust(ch, 0, 0));
+    *out++ = Utf8Adjust(ch, 0, 0);
   } else if (ch < 0x800) {
-    q.push_back(Utf8Adjust(ch, 2, 6));
-    q.push_back(Utf8Adjust(ch, 1, 0));
+    *out++ = Utf8Adjust(ch, 2, 6);
+    *out++ = Utf8Adjust(ch, 1, 0);
   } else if (ch < 0x10000) {
-    q.push_back(Utf8Adjust(ch, 3, 12));
-    q.push_back(Utf8Adjust(ch, 1, 6));
-    q.push_back(Utf8Adjust(ch, 1, 0));
+    *out++ = Utf8Adjust(ch, 3, 12);
+    *out++ = Utf8Adjust(ch, 1, 6);
+    *out++ = Utf8Adjust(ch, 1, 0);
   } else {
-    q.push_back(Utf8Adjust(ch, 4, 18));
-    q.push_back(Utf8Adjust(ch, 1, 12));
-    q.push_back(Utf8Adjust(ch, 1, 6));
-    q.push_back(Utf8Adjust(ch, 1, 0));
+    *out++ = Utf8Adjust(ch, 4, 18);
+    *out++ = Utf8Adjust(ch, 1, 12);
+    *out++ = Utf8Adjust(ch, 1, 6);
+    *out++ = Utf8Adjust(ch, 1, 0);
+  }
+  return out;
+}
+
+inline void QueueUnicodeCodepoint(std::vector<char>& q, unsigned long ch) {
+  char buffer[4];
+  q.insert(q.end(), buffer, WriteUnicodeCodepoint(buffer, ch));
+}
+
+#ifdef YAML_STREAM_SSE2
+// Copies the leading run of ASCII characters (other than eof, which has to be
+// replaced) eight UTF-16 code units at a time, returning the number of code
+// units copied.
+inline std::size_t CopyAsciiUtf16(const unsigned char* pBytes,
+                                  std::size_t nUnits, bool bigEndian,
+                                  char* out) {
+  // a big-endian ASCII code unit is 0x00XX, which loads as 0xXX00
+  const __m128i nonAscii =
+      _mm_set1_epi16(static_cast<short>(bigEndian ? 0x80FF : 0xFF80));
+  const __m128i eof = _mm_set1_epi16(Stream::eof());
+  const __m128i zero = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 8 <= nUnits; i += 8) {
+    __m128i units =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBytes + 2 * i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, nonAscii),
+                                          zero)) != 0xFFFF) {
+      break;
+    }
+    if (bigEndian) {
+      units = _mm_srli_epi16(units, 8);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(units, eof)) != 0) {
+      break;
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+                     _mm_packus_epi16(units, units));
+  }
+  return i;
+}
+
+// Same as above for UTF-32, four code units at a time.
+inline std::size_t CopyAsciiUtf32(const unsigned char* pBytes,
+                                  std::size_t nUnits, bool bigEndian,
+                                  char* out) {
+  // a big-endian ASCII code unit is 0x000000XX, which loads as 0xXX000000
+  const __m128i nonAscii = _mm_set1_epi32(
+      static_cast<int>(bigEndian ? 0x80FFFFFFu : 0xFFFFFF80u));
+  const __m128i eof = _mm_set1_epi32(Stream::eof());
+  const __m128i zero = _mm_setzero_si128();
+
+  std::size_t i = 0;
+  for (; i + 4 <= nUnits; i += 4) {
+    __m128i units =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBytes + 4 * i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(units, nonAscii),
+                                          zero)) != 0xFFFF) {
+      break;
+    }
+    if (bigEndian) {
+      units = _mm_srli_epi32(units, 24);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(units, eof)) != 0) {
+      break;
+    }
+    units = _mm_packs_epi32(units, units);
+    const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(units, units));
+    std::memcpy(out + i, &packed, 4);
+  }
+  return i;
+}
+#endif
+
+// Transcodes the complete UTF-16 code units (and surrogate pairs) at the
+// start of [pBytes, pBytes + size) to UTF-8, appending them to q. Returns the
+// number of bytes used; whatever is left over needs more input.
+inline std::size_t TranscodeUtf16(const unsigned char* pBytes,
+                                  std::size_t size, bool bigEndian,
+                                  std::vector<char>& q) {
+  const int nBigEnd = bigEndian ? 0 : 1;
+  const std::size_t start = q.size();
+  q.resize(start + size / 2 * 3);
+  char* out = &q[0] + start;
+
+  std::size_t i = 0;
+  while (i + 2 <= size) {
+#ifdef YAML_STREAM_SSE2
+    const std::size_t nAscii =
+        CopyAsciiUtf16(pBytes + i, (size - i) / 2, bigEndian, out);
+    i += 2 * nAscii;
+    out += nAscii;
+#endif
+
+    // and the next few code units the slow way
+    const std::size_t end = std::min(size, i + 16);
+    while (i + 2 <= end) {
+      unsigned long ch =
+          (static_cast<unsigned long>(pBytes[i + nBigEnd]) << 8) |
+          static_cast<unsigned long>(pBytes[i + (1 ^ nBigEnd)]);
+
+      if (ch >= 0xD800 && ch < 0xDC00) {
+        // ch is a leading (high) surrogate, so we need the trailing one
+        if (i + 4 > size) {
+          q.resize(static_cast<std::size_t>(out - &q[0]));
+          return i;
+        }
+        unsigned long chLow =
+            (static_cast<unsigned long>(pBytes[i + 2 + nBigEnd]) << 8) |
+            static_cast<unsigned long>(pBytes[i + 2 + (1 ^ nBigEnd)]);
+        if (chLow < 0xDC00 || chLow >= 0xE000) {
+          // Not a low surrogate: dump a REPLACEMENT CHARACTER into the
+          // stream, and deal with the next code unit on its own
+          out = WriteUnicodeCodepoint(out, CP_REPLACEMENT_CHARACTER);
+          i += 2;
+          continue;
+        }
+        ch = (((ch & 0x3FF) << 10) | (chLow & 0x3FF)) + 0x10000;
+        i += 2;
+      } else if (ch >= 0xDC00 && ch < 0xE000) {
+        // Trailing (low) surrogate...ugh, wrong order
+        ch = CP_REPLACEMENT_CHARACTER;
+      }
+
+      out = WriteUnicodeCodepoint(out, ch);
+      i += 2;
+    }
+  }
+
+  q.resize(static_cast<std::size_t>(out - &q[0]));
+  return i;
+}
+
+// Same as above for UTF-32.
+inline std::size_t TranscodeUtf32(const unsigned char* pBytes,
+                                  std::size_t size, bool bigEndian,
+                                  std::vector<char>& q) {
+  const std::size_t start = q.size();
+  q.resize(start + size / 4 * 4);
+  char* out = &q[0] + start;
+
+  std::size_t i = 0;
+  while (i + 4 <= size) {
+#ifdef YAML_STREAM_SSE2
+    const std::size_t nAscii =
+        CopyAsciiUtf32(pBytes + i, (size - i) / 4, bigEndian, out);
+    i += 4 * nAscii;
+    out += nAscii;
+#endif
+
+    const std::size_t end = std::min(size, i + 16);
+    for (; i + 4 <= end; i += 4) {
+      unsigned long ch = 0;
+      for (int j = 0; j < 4; ++j) {
+        ch <<= 8;
+        ch |= pBytes[i + static_cast<std::size_t>(bigEndian ? j : 3 - j)];
+      }
+      out = WriteUnicodeCodepoint(out, ch);
+    }
+  }
+
+  q.resize(static_cast<std::size_t>(out - &q[0]));
+  return i;
+}
+
+// Determines (or guesses) the character set of [data, data + size) from its
+// first few bytes, without reading past its end, and sets nIntroUsed to the
+// number of them that are a BOM. See the YAML specification for the
+// determination algorithm; "ungetting" a byte of the intro is just a matter
+// of moving back in the buffer.
+UtfIntroState ReadIntro(const char* data, std::size_t size,
+                        std::size_t& nIntroUsed) {
+  using char_traits = std::istream::traits_type;
+
+  nIntroUsed = 0;
+  UtfIntroState state = uis_start;
+  for (; !s_introFinalState[state];) {
+    char_traits::int_type ch =
+        nIntroUsed < size ? static_cast<unsigned char>(data[nIntroUsed])
+                          : char_traits::eof();
+    nIntroUsed++;
+    UtfIntroCharType charType = IntroCharTypeOf(ch);
+    UtfIntroState newState = s_introTransitions[state][charType];
+    nIntroUsed -= static_cast<std::size_t>(s_introUngetCount[state][charType]);
+    state = newState;
+  }
+
+  nIntroUsed = std::min(nIntroUsed, size);
+  return state;
+}
+
+inline Stream::CharacterSet CharacterSetFor(UtfIntroState state) {
+  switch (state) {
+    case uis_utf16le:
+      return Stream::utf16le;
+    case uis_utf16be:
+      return Stream::utf16be;
+    case uis_utf32le:
+      return Stream::utf32le;
+    case uis_utf32be:
+      return Stream::utf32be;
+    default:
+      return Stream::utf8;
   }
 }
 
 Stream::Stream(std::istream& input)
-    : m_input(input),
+    : m_pInput(&input),
       m_mark{},
+      m_pMemory(nullptr),
+      m_memorySize(0),
+      m_memoryUsed(0),
+      m_inPlace(false),
+      m_memoryExhausted(false),
       m_charSet{},
       m_readahead{},
+      m_readaheadUsed(0),
+      m_pWindow(nullptr),
+      m_windowSize(0),
       m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
       m_nPrefetchedAvailable(0),
-      m_nPrefetchedUsed(0) {
+      m_nPrefetchedUsed(0),
+      m_pLines{},
+      m_line(0),
+      m_lineStart(0),
+      m_pushed(false),
+      m_closed(false),
+      m_introRead(false),
+      m_pushedBytes{},
+      m_savedMark{},
+      m_savedLineEndingSymbol(0),
+      m_savedReadaheadUsed(0) {
   using char_traits = std::istream::traits_type;
 
   if (!input)
@@ -216,43 +445,146 @@ Stream::Stream(std::istream& input)
     state = newState;
   }
 
-  switch (state) {
-    case uis_utf8:
-      m_charSet = utf8;
-      break;
-    case uis_utf16le:
-      m_charSet = utf16le;
-      break;
-    case uis_utf16be:
-      m_charSet = utf16be;
-      break;
-    case uis_utf32le:
-      m_charSet = utf32le;
-      break;
-    case uis_utf32be:
-      m_charSet = utf32be;
-      break;
-    default:
-      m_charSet = utf8;
-      break;
-  }
+  m_charSet = CharacterSetFor(state);
+  ReadAheadTo(0);
+}
 
+Stream::Stream(const char* data, std::size_t size, MarkMode marks)
+    : m_pInput(nullptr),
+      m_mark{},
+      m_pMemory(data),
+      m_memorySize(size),
+      m_memoryUsed(0),
+      m_inPlace(false),
+      m_memoryExhausted(false),
+      m_charSet{},
+      m_readahead{},
+      m_readaheadUsed(0),
+      m_pWindow(nullptr),
+      m_windowSize(0),
+      m_pPrefetched{},
+      m_nPrefetchedAvailable(0),
+      m_nPrefetchedUsed(0),
+      m_pLines{},
+      m_line(0),
+      m_lineStart(0),
+      m_pushed(false),
+      m_closed(false),
+      m_introRead(false),
+      m_pushedBytes{},
+      m_savedMark{},
+      m_savedLineEndingSymbol(0),
+      m_savedReadaheadUsed(0) {
+  m_charSet = CharacterSetFor(ReadIntro(data, size, m_memoryUsed));
+
+  // UTF-8 needs no decoding, so we can scan it where it lies
+  if (m_charSet == utf8) {
+    m_inPlace = true;
+    m_pWindow = data + m_memoryUsed;
+    m_windowSize = size - m_memoryUsed;
+    m_memoryUsed = size;
+    m_memoryExhausted = true;
+
+    if (marks == MarkMode::Offset) {
+      m_pLines.reset(new LineIndex(data, size));
+      m_lineEndingSymbol = m_pLines->lineEnding();
+    }
+  }
   ReadAheadTo(0);
 }
 
-Stream::~Stream() { delete[] m_pPrefetched; }
+Stream::Stream(const char* data, std::size_t size, const Mark& start,
+               char lineEnding)
+    : Stream(data, size) {
+  m_mark = start;
+  m_lineEndingSymbol = lineEnding;
+}
 
-char Stream::peek() const {
-  if (m_readahead.empty()) {
-    return Stream::eof();
+Stream::Stream()
+    : m_pInput(nullptr),
+      m_mark{},
+      m_pMemory(nullptr),
+      m_memorySize(0),
+      m_memoryUsed(0),
+      m_inPlace(false),
+      m_memoryExhausted(false),
+      m_charSet{},
+      m_readahead{},
+      m_readaheadUsed(0),
+      m_pWindow(nullptr),
+      m_windowSize(0),
+      m_pPrefetched{},
+      m_nPrefetchedAvailable(0),
+      m_nPrefetchedUsed(0),
+      m_pLines{},
+      m_line(0),
+      m_lineStart(0),
+      m_pushed(true),
+      m_closed(false),
+      m_introRead(false),
+      m_pushedBytes{},
+      m_savedMark{},
+      m_savedLineEndingSymbol(0),
+      m_savedReadaheadUsed(0) {}
+
+Stream::~Stream() = default;
+
+void Stream::Push(const char* data, std::size_t size) {
+  // the bytes that have been decoded are in the readahead buffer now
+  m_pushedBytes.erase(0, m_memoryUsed);
+  m_memoryUsed = 0;
+  m_pushedBytes.append(data, size);
+
+  // (the intro is at most four bytes)
+  if (m_introRead) {
+    m_pMemory = m_pushedBytes.data();
+    m_memorySize = m_pushedBytes.size();
+  } else if (m_pushedBytes.size() >= 4) {
+    ReadPushedIntro();
   }
+}
+
+void Stream::Close() {
+  m_closed = true;
+  if (!m_introRead)
+    ReadPushedIntro();
+  FillWindow();
+}
+
+void Stream::ReadPushedIntro() {
+  m_charSet = CharacterSetFor(
+      ReadIntro(m_pushedBytes.data(), m_pushedBytes.size(), m_memoryUsed));
+  m_introRead = true;
+  m_pMemory = m_pushedBytes.data();
+  m_memorySize = m_pushedBytes.size();
+}
+
+void Stream::Save() {
+  m_savedMark = m_mark;
+  m_savedLineEndingSymbol = m_lineEndingSymbol;
+  m_savedReadaheadUsed = m_readaheadUsed;
+}
 
-  return m_readahead[0];
+void Stream::Restore() {
+  m_mark = m_savedMark;
+  m_lineEndingSymbol = m_savedLineEndingSymbol;
+  m_readaheadUsed = m_savedReadaheadUsed;
+  UpdateWindow();
 }
 
+std::size_t Stream::savedSize() const {
+  return m_readahead.size() - m_savedReadaheadUsed + m_pushedBytes.size() -
+         m_memoryUsed;
+}
+
+bool Stream::InputGood() const {
+  return m_pInput ? m_pInput->good() : !m_memoryExhausted;
+}
+
+char Stream::peek() const { return CharAt(0); }
+
 Stream::operator bool() const {
-  return m_input.good() ||
-         (!m_readahead.empty() && m_readahead[0] != Stream::eof());
+  return InputGood() || (m_windowSize > 0 && m_pWindow[0] != Stream::eof());
 }
 
 // get
@@ -260,6 +592,13 @@ Stream::operator bool() const {
 char Stream::get() {
   char ch = peek();
   AdvanceCurrent();
+  if (m_pLines) {
+    if (ch == m_lineEndingSymbol) {
+      m_line++;
+      m_lineStart = m_mark.pos;
+    }
+    return ch;
+  }
   m_mark.column++;
 
   // if line ending symbol is unknown, set it to the first
@@ -306,17 +645,120 @@ void Stream::eat(int n) {
     get();
 }
 
+void Stream::eatInLine(std::size_t n) {
+  if (n == 0)
+    return;
+  m_pWindow += n;
+  m_windowSize -= n;
+  if (!m_inPlace)
+    m_readaheadUsed += n;
+  m_mark.pos += static_cast<int>(n);
+  m_mark.column += static_cast<int>(n);
+
+  FillWindow();
+}
+
+void Stream::eatLines(std::size_t n) {
+  // the first line ending decides the symbol, as in get()
+  for (std::size_t i = 0; !m_lineEndingSymbol && i < n; ++i) {
+    if (CharAt(i) == '\n') {
+      m_lineEndingSymbol = '\n';
+    } else if (CharAt(i) == '\r') {
+      ReadAheadTo(i + 1);
+      m_lineEndingSymbol = CharAt(i + 1) == '\n' ? '\n' : '\r';
+    }
+  }
+
+  const char* const chars = m_pWindow;
+  const char* const end = chars + n;
+  int lines = 0;
+  const char* lineStart = nullptr;
+  for (const char* p = chars; m_lineEndingSymbol && p < end; ++p) {
+    p = static_cast<const char*>(std::memchr(
+        p, m_lineEndingSymbol, static_cast<std::size_t>(end - p)));
+    if (!p)
+      break;
+    lines++;
+    lineStart = p + 1;
+  }
+
+  eatInLine(n);
+  if (!lineStart)
+    return;
+
+  const int column = static_cast<int>(end - lineStart);
+  if (m_pLines) {
+    m_line += lines;
+    m_lineStart = m_mark.pos - column;
+  } else {
+    m_mark.line += lines;
+    m_mark.column = column;
+  }
+}
+
+void Stream::ResetColumn() {
+  if (m_pLines)
+    m_lineStart = m_mark.pos;
+  else
+    m_mark.column = 0;
+}
+
+Mark Stream::OffsetMark() const {
+  Mark mark = Mark::null_mark();
+  mark.pos = m_mark.pos;
+  return mark;
+}
+
 void Stream::AdvanceCurrent() {
-  if (!m_readahead.empty()) {
-    m_readahead.pop_front();
-    m_mark.pos++;
+  if (m_windowSize > 0) {
+    ++m_pWindow;
+    --m_windowSize;
+    if (!m_inPlace)
+      ++m_readaheadUsed;
   }
+  m_mark.pos++;
 
-  ReadAheadTo(0);
+  FillWindow();
+}
+
+// PushedCharAt
+// . CharAt past the window, for pushed input: that's read ahead on demand,
+//   so running out of it (before its end) throws MoreInputNeeded
+char Stream::PushedCharAt(size_t i) const {
+  return ReadAheadTo(i) && i < m_windowSize ? m_pWindow[i] : Stream::eof();
 }
 
 bool Stream::_ReadAheadTo(size_t i) const {
-  while (m_input.good() && (m_readahead.size() <= i)) {
+  if (Fill(i))
+    return true;
+  if (m_pushed && !m_closed)
+    throw MoreInputNeeded();
+  return false;
+}
+
+// Fill
+// . Reads ahead to the given character if it can, without ever throwing
+//   MoreInputNeeded
+bool Stream::Fill(size_t i) const {
+  // pushed input is kept from the saved position on
+  const std::size_t used =
+      m_pushed ? std::min(m_readaheadUsed, m_savedReadaheadUsed)
+               : m_readaheadUsed;
+  if (InputGood() && used > 0) {
+    // Slide the unread characters back to the front of the buffer, but only
+    // once there's enough to make it worth moving them.
+    if (used == m_readahead.size() || used >= YAML_PREFETCH_SIZE) {
+      m_readahead.erase(
+          m_readahead.begin(),
+          m_readahead.begin() + static_cast<std::ptrdiff_t>(used));
+      m_readaheadUsed -= used;
+      if (m_pushed)
+        m_savedReadaheadUsed -= used;
+    }
+  }
+
+  while (InputGood() && (m_readahead.size() - m_readaheadUsed <= i)) {
+    const std::size_t size = m_readahead.size();
     switch (m_charSet) {
       case utf8:
         StreamInUtf8();
@@ -334,30 +776,75 @@ bool Stream::_ReadAheadTo(size_t i) const {
         StreamInUtf32();
         break;
     }
+
+    // what's left of pushed input (if anything) waits for the next chunk
+    if (m_pushed && !m_closed && m_readahead.size() == size)
+      break;
   }
+  UpdateWindow();
 
-  // signal end of stream
-  if (!m_input.good())
-    m_readahead.push_back(Stream::eof());
+  // at the end of the stream, there's (only) one more character: eof
+  return m_windowSize > i || (!InputGood() && m_windowSize == i);
+}
 
-  return m_readahead.size() > i;
+void Stream::UpdateWindow() const {
+  if (m_inPlace)
+    return;
+  m_pWindow = m_readahead.data() + m_readaheadUsed;
+  m_windowSize = m_readahead.size() - m_readaheadUsed;
 }
 
 void Stream::StreamInUtf8() const {
+  // pushed input is passed through a block at a time too, as far as it goes
+  if (m_pushed) {
+    std::size_t nBytes = 0;
+    const unsigned char* pBytes = PendingBytes(nBytes);
+    if (nBytes > 0 || !m_closed) {
+      m_readahead.insert(m_readahead.end(), pBytes, pBytes + nBytes);
+      SkipBytes(nBytes);
+      return;
+    }
+  }
+
   unsigned char b = GetNextByte();
-  if (m_input.good()) {
-    m_readahead.push_back(static_cast<char>(b));
+  if (!InputGood()) {
+    return;
+  }
+  m_readahead.push_back(static_cast<char>(b));
+
+  // UTF-8 is passed through as is, so there's no need to go byte by byte:
+  // take the rest of the prefetched block in one go
+  if (m_pInput && m_nPrefetchedUsed < m_nPrefetchedAvailable) {
+    m_readahead.insert(m_readahead.end(),
+                       m_pPrefetched.get() + m_nPrefetchedUsed,
+                       m_pPrefetched.get() + m_nPrefetchedAvailable);
+    m_nPrefetchedUsed = m_nPrefetchedAvailable;
   }
 }
 
 void Stream::StreamInUtf16() const {
+  // Transcode all of the input we already have in one go; only a code unit
+  // (or surrogate pair) that's split across reads is read byte by byte.
+  std::size_t nBytes = 0;
+  const unsigned char* pBytes = PendingBytes(nBytes);
+  if (nBytes >= 2) {
+    std::size_t nUsed =
+        TranscodeUtf16(pBytes, nBytes, m_charSet == utf16be, m_readahead);
+    if (nUsed > 0) {
+      SkipBytes(nUsed);
+      return;
+    }
+  }
+  if (m_pushed && !m_closed)
+    return;  // a code unit that's split across chunks waits for the rest
+
   unsigned long ch = 0;
   unsigned char bytes[2];
   int nBigEnd = (m_charSet == utf16be) ? 0 : 1;
 
   bytes[0] = GetNextByte();
   bytes[1] = GetNextByte();
-  if (!m_input.good()) {
+  if (!InputGood()) {
     return;
   }
   ch = (static_cast<unsigned long>(bytes[nBigEnd]) << 8) |
@@ -378,7 +865,7 @@ void Stream::StreamInUtf16() const {
     for (;;) {
       bytes[0] = GetNextByte();
       bytes[1] = GetNextByte();
-      if (!m_input.good()) {
+      if (!InputGood()) {
         QueueUnicodeCodepoint(m_readahead, CP_REPLACEMENT_CHARACTER);
         return;
       }
@@ -392,7 +879,7 @@ void Stream::StreamInUtf16() const {
         // Deal with the next UTF-16 unit
         if (chLow < 0xD800 || chLow >= 0xE000) {
           // Easiest case: queue the codepoint and return
-          QueueUnicodeCodepoint(m_readahead, ch);
+          QueueUnicodeCodepoint(m_readahead, chLow);
           return;
         }
         // Start the loop over with the new high surrogate
@@ -420,14 +907,42 @@ inline char* ReadBuffer(unsigned char* pBuffer) {
   return reinterpret_cast<char*>(pBuffer);
 }
 
+const unsigned char* Stream::PendingBytes(std::size_t& size) const {
+  if (!m_pInput) {
+    // don't decode too far ahead of the scanner
+    size = std::min<std::size_t>(m_memorySize - m_memoryUsed,
+                                 YAML_PREFETCH_SIZE);
+    return reinterpret_cast<const unsigned char*>(m_pMemory) + m_memoryUsed;
+  }
+
+  size = m_nPrefetchedAvailable - m_nPrefetchedUsed;
+  return m_pPrefetched.get() + m_nPrefetchedUsed;
+}
+
+void Stream::SkipBytes(std::size_t n) const {
+  if (!m_pInput) {
+    m_memoryUsed += n;
+  } else {
+    m_nPrefetchedUsed += n;
+  }
+}
+
 unsigned char Stream::GetNextByte() const {
+  if (!m_pInput) {
+    if (m_memoryUsed < m_memorySize) {
+      return static_cast<unsigned char>(m_pMemory[m_memoryUsed++]);
+    }
+    m_memoryExhausted = true;
+    return 0;
+  }
+
   if (m_nPrefetchedUsed >= m_nPrefetchedAvailable) {
-    std::streambuf* pBuf = m_input.rdbuf();
+    std::streambuf* pBuf = m_pInput->rdbuf();
     m_nPrefetchedAvailable = static_cast<std::size_t>(
-        pBuf->sgetn(ReadBuffer(m_pPrefetched), YAML_PREFETCH_SIZE));
+        pBuf->sgetn(ReadBuffer(m_pPrefetched.get()), YAML_PREFETCH_SIZE));
     m_nPrefetchedUsed = 0;
     if (!m_nPrefetchedAvailable) {
-      m_input.setstate(std::ios_base::eofbit);
+      m_pInput->setstate(std::ios_base::eofbit);
     }
 
     if (0 == m_nPrefetchedAvailable) {
@@ -441,6 +956,19 @@ unsigned char Stream::GetNextByte() const {
 void Stream::StreamInUtf32() const {
   static int indexes[2][4] = {{3, 2, 1, 0}, {0, 1, 2, 3}};
 
+  std::size_t nBytes = 0;
+  const unsigned char* pBytes = PendingBytes(nBytes);
+  if (nBytes >= 4) {
+    std::size_t nUsed =
+        TranscodeUtf32(pBytes, nBytes, m_charSet == utf32be, m_readahead);
+    if (nUsed > 0) {
+      SkipBytes(nUsed);
+      return;
+    }
+  }
+  if (m_pushed && !m_closed)
+    return;  // a code unit that's split across chunks waits for the rest
+
   unsigned long ch = 0;
   unsigned char bytes[4];
   int* pIndexes = (m_charSet == utf32be) ? indexes[1] : indexes[0];
@@ -449,7 +977,7 @@ void Stream::StreamInUtf32() const {
   bytes[1] = GetNextByte();
   bytes[2] = GetNextByte();
   bytes[3] = GetNextByte();
-  if (!m_input.good()) {
+  if (!InputGood()) {
     return;
   }
 
@@ -7,23 +7,47 @@
 #pragma once
 #endif
 
+#include "yaml-cpp/lineindex.h"
 #include "yaml-cpp/mark.h"
 #include <cstddef>
-#include <deque>
 #include <ios>
 #include <istream>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace YAML {
 
 class StreamCharSource;
 
+// Thrown when the input that's pushed to a stream (see Stream::Push) runs out
+// before its end, so that whatever was reading it has to wait for more.
+struct MoreInputNeeded {};
+
 class Stream {
  public:
   friend class StreamCharSource;
 
+  enum CharacterSet { utf8, utf16le, utf16be, utf32le, utf32be };
+
   Stream(std::istream& input);
+
+  // Reads input that's pushed to it in chunks (see Push), which is decoded
+  // into the readahead buffer as usual, and dropped once it's been read.
+  Stream();
+
+  // Reads directly from the given buffer, which must outlive the stream.
+  // UTF-8 input is scanned in place, without being copied; and only then
+  // can its marks be offsets only (otherwise they're always in full).
+  Stream(const char* data, std::size_t size,
+         MarkMode marks = MarkMode::LineColumn);
+
+  // Reads a part of some larger buffer, which starts at the start of a line:
+  // its marks carry on from the given one, and its lines end as the larger
+  // buffer's do.
+  Stream(const char* data, std::size_t size, const Mark& start,
+         char lineEnding);
   Stream(const Stream&) = delete;
   Stream(Stream&&) = delete;
   Stream& operator=(const Stream&) = delete;
@@ -38,46 +62,131 @@ class Stream {
   std::string get(int n);
   void eat(int n = 1);
 
+  // Eats the first n characters of the window, which mustn't include a line
+  // ending, all at once.
+  void eatInLine(std::size_t n);
+
+  // Eats the first n characters of the window, line endings and all, at once.
+  void eatLines(std::size_t n);
+
   static char eof() { return 0x04; }
 
-  const Mark mark() const { return m_mark; }
+  // Pushed input: takes the next chunk (which is copied), or the end of it.
+  // Until the end, reading past what's there throws MoreInputNeeded.
+  void Push(const char* data, std::size_t size);
+  void Close();
+  bool pushed() const { return m_pushed; }
+
+  // Pushed input: saves the current position, or goes back to it; so the
+  // input is kept from there on, until the next save.
+  void Save();
+  void Restore();
+
+  // Pushed input: how much of it there is from the saved position on (in
+  // characters, and bytes that haven't been decoded yet).
+  std::size_t savedSize() const;
+
+  // The characters that have already been read ahead, starting with the
+  // current one. Only valid until the stream is next advanced or read ahead.
+  const char* window() const { return m_pWindow; }
+  std::size_t windowSize() const { return m_windowSize; }
+
+  // Whether the window is the whole rest of the input, read in place.
+  bool readsInPlace() const { return m_inPlace; }
+
+  const Mark mark() const { return m_pLines ? OffsetMark() : m_mark; }
   int pos() const { return m_mark.pos; }
-  int line() const { return m_mark.line; }
-  int column() const { return m_mark.column; }
-  void ResetColumn() { m_mark.column = 0; }
+  int line() const { return m_pLines ? m_line : m_mark.line; }
+  int column() const {
+    return m_pLines ? m_mark.pos - m_lineStart : m_mark.column;
+  }
+  void ResetColumn();
 
- private:
-  enum CharacterSet { utf8, utf16le, utf16be, utf32le, utf32be };
+  // The given mark in full, if it's only an offset.
+  Mark Locate(const Mark& mark) const {
+    return m_pLines ? m_pLines->Locate(mark) : mark;
+  }
 
-  std::istream& m_input;
+ private:
+  std::istream* m_pInput;  // nullptr when reading from memory
   Mark m_mark;
 
+  // in-memory input
+  const char* m_pMemory;
+  std::size_t m_memorySize;
+  mutable std::size_t m_memoryUsed;
+  bool m_inPlace;  // UTF-8 memory input: the window is m_pMemory itself
+  mutable bool m_memoryExhausted;
+
   CharacterSet m_charSet;
   char m_lineEndingSymbol{}; // 0 means it is not determined yet, must be '\n' or '\r'
-  mutable std::deque<char> m_readahead;
-  unsigned char* const m_pPrefetched;
+  mutable std::vector<char> m_readahead;
+  mutable std::size_t m_readaheadUsed;
+  mutable const char* m_pWindow;
+  mutable std::size_t m_windowSize;
+  const std::unique_ptr<unsigned char[]> m_pPrefetched;
   mutable size_t m_nPrefetchedAvailable;
   mutable size_t m_nPrefetchedUsed;
 
+  // offset marks: the line ending is known up front, and we only keep track
+  // of where the current line starts (the scanner still needs its columns)
+  std::unique_ptr<LineIndex> m_pLines;
+  int m_line;
+  int m_lineStart;
+
+  // pushed input: the bytes that m_pMemory refers to (once the intro has been
+  // read, which takes four of them), and the saved position
+  bool m_pushed;
+  bool m_closed;
+  bool m_introRead;
+  std::string m_pushedBytes;
+  Mark m_savedMark;
+  char m_savedLineEndingSymbol;
+  mutable std::size_t m_savedReadaheadUsed;
+
+  Mark OffsetMark() const;
+
+  bool InputGood() const;
+  void ReadPushedIntro();
   void AdvanceCurrent();
   char CharAt(size_t i) const;
+  char PushedCharAt(size_t i) const;
   bool ReadAheadTo(size_t i) const;
+  void FillWindow() const;
   bool _ReadAheadTo(size_t i) const;
+  bool Fill(size_t i) const;
+  void UpdateWindow() const;
   void StreamInUtf8() const;
   void StreamInUtf16() const;
   void StreamInUtf32() const;
+  const unsigned char* PendingBytes(std::size_t& size) const;
+  void SkipBytes(std::size_t n) const;
   unsigned char GetNextByte() const;
 };
 
 // CharAt
-// . Unchecked access
-inline char Stream::CharAt(size_t i) const { return m_readahead[i]; }
+// . Reads from the window; past its end (which can only be after a failed
+//   ReadAheadTo), we're at eof, unless the input is pushed and there's more
+//   to come
+inline char Stream::CharAt(size_t i) const {
+  if (i < m_windowSize)
+    return m_pWindow[i];
+  return m_pushed ? PushedCharAt(i) : Stream::eof();
+}
 
 inline bool Stream::ReadAheadTo(size_t i) const {
-  if (m_readahead.size() > i)
+  if (m_windowSize > i)
     return true;
   return _ReadAheadTo(i);
 }
+
+// FillWindow
+// . Reads ahead once the stream has been advanced past its window, but only
+//   as far as the input that's there (so it never needs more)
+inline void Stream::FillWindow() const {
+  if (m_windowSize == 0)
+    Fill(0);
+}
 }  // namespace YAML
 
 #endif  // STREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/mark.h"
+#include "yaml-cpp/stringref.h"
 #include <ostream>
 #include <string>
 #include <vector>
@@ -50,10 +51,21 @@ struct Token {
 
   // data
   Token(TYPE type_, const Mark& mark_)
-      : status(VALID), type(type_), mark(mark_), value{}, params{}, data(0) {}
+      : status(VALID),
+        type(type_),
+        mark(mark_),
+        value{},
+        slice{},
+        sliced(false),
+        params{},
+        data(0) {}
+
+  // The value of a scalar that's a verbatim slice of the input (when that's
+  // read in place) is only referred to; any other value is its own string.
+  StringRef text() const { return sliced ? slice : StringRef(value); }
 
   friend std::ostream& operator<<(std::ostream& out, const Token& token) {
-    out << TokenNames[token.type] << std::string(": ") << token.value;
+    out << TokenNames[token.type] << std::string(": ") << token.text();
     for (const std::string& param : token.params)
       out << std::string(" ") << param;
     return out;
@@ -63,6 +75,8 @@ struct Token {
   TYPE type;
   Mark mark;
   std::string value;
+  StringRef slice;
+  bool sliced;
   std::vector<std::string> params;
   int data;
 };
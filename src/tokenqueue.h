@@ -0,0 +1,110 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "token.h"
+
+namespace YAML {
+/**
+ * A queue of tokens that are recycled: each one is allocated once and then
+ * reused, around a ring, by later tokens. The ring only grows (by a block of
+ * tokens at a time) when the queue outgrows it, and (like a deque) never moves
+ * a token that's in the queue, so pointers to them stay valid.
+ *
+ * It can also hold on to the tokens that are popped, so that they can be put
+ * back (see {@link #hold}).
+ */
+class TokenQueue {
+ public:
+  TokenQueue()
+      : m_blocks{},
+        m_ring{},
+        m_front(0),
+        m_size(0),
+        m_holding(false),
+        m_held(0) {}
+  TokenQueue(const TokenQueue&) = delete;
+  TokenQueue& operator=(const TokenQueue&) = delete;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() { return *m_ring[m_front]; }
+  const Token& front() const { return *m_ring[m_front]; }
+  Token& back() { return *m_ring[Slot(m_size - 1)]; }
+
+  void push(Token&& token) {
+    if (m_size + m_held == m_ring.size())
+      Grow();
+    *m_ring[Slot(m_size)] = std::move(token);
+    m_size++;
+  }
+
+  void pop() {
+    m_front = Slot(1);
+    m_size--;
+    if (m_holding)
+      m_held++;
+  }
+
+  /**
+   * From now on, keeps the tokens that are popped (as they were) until they
+   * are released, or put back at the front of the queue.
+   */
+  void hold() { m_holding = true; }
+  void release() { m_held = 0; }
+  void unpop() {
+    if (m_held == 0)
+      return;
+    m_front = (m_front + m_ring.size() - m_held) % m_ring.size();
+    m_size += m_held;
+    m_held = 0;
+  }
+
+  /** Drops the tokens at the back of the queue, after the first n. */
+  void truncate(std::size_t n) { m_size = std::min(m_size, n); }
+
+ private:
+  std::size_t Slot(std::size_t i) const {
+    return (m_front + i) % m_ring.size();
+  }
+
+  void Grow() {
+    // (the held tokens are just before the front)
+    if (!m_ring.empty()) {
+      const std::size_t first =
+          (m_front + m_ring.size() - m_held) % m_ring.size();
+      std::rotate(m_ring.begin(),
+                  m_ring.begin() + static_cast<std::ptrdiff_t>(first),
+                  m_ring.end());
+    }
+    m_front = m_held;
+
+    // the new tokens come in one block, which never moves them (even when
+    // the list of blocks does)
+    const std::size_t n = std::max<std::size_t>(m_ring.size(), 16);
+    m_blocks.emplace_back(n, Token(Token::DOC_START, Mark()));
+    for (Token& token : m_blocks.back())
+      m_ring.push_back(&token);
+  }
+
+  std::vector<std::vector<Token>> m_blocks;
+  std::vector<Token*> m_ring;
+  std::size_t m_front;
+  std::size_t m_size;
+  bool m_holding;
+  std::size_t m_held;  // the tokens just before the front, if holding
+};
+}  // namespace YAML
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -105,6 +105,22 @@ class EncodingTest : public HandlerTest {
     Parse(m_yaml.str());
   }
 
+  void RunFromMemory() {
+    InSequence sequence;
+    EXPECT_CALL(handler, OnDocumentStart(_));
+    EXPECT_CALL(handler, OnSequenceStart(_, "?", 0, EmitterStyle::Block));
+    for (std::size_t i = 0; i < m_entries.size(); i++) {
+      EXPECT_CALL(handler, OnScalar(_, "!", 0, m_entries[i]));
+    }
+    EXPECT_CALL(handler, OnSequenceEnd());
+    EXPECT_CALL(handler, OnDocumentEnd());
+
+    const std::string yaml = m_yaml.str();
+    Parser parser(yaml.data(), yaml.size());
+    while (parser.HandleNextDocument(handler)) {
+    }
+  }
+
  private:
   std::stringstream m_yaml;
   std::vector<std::string> m_entries;
@@ -178,5 +194,131 @@ TEST_F(EncodingTest, UTF32BE_BOM) {
   SetUpEncoding(&EncodeToUtf32BE, true);
   Run();
 }
+TEST_F(EncodingTest, UTF8_noBOM_memory) {
+  SetUpEncoding(&EncodeToUtf8, false);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF8_BOM_memory) {
+  SetUpEncoding(&EncodeToUtf8, true);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF16LE_noBOM_memory) {
+  SetUpEncoding(&EncodeToUtf16LE, false);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF16LE_BOM_memory) {
+  SetUpEncoding(&EncodeToUtf16LE, true);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF16BE_noBOM_memory) {
+  SetUpEncoding(&EncodeToUtf16BE, false);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF16BE_BOM_memory) {
+  SetUpEncoding(&EncodeToUtf16BE, true);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF32LE_noBOM_memory) {
+  SetUpEncoding(&EncodeToUtf32LE, false);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF32LE_BOM_memory) {
+  SetUpEncoding(&EncodeToUtf32LE, true);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF32BE_noBOM_memory) {
+  SetUpEncoding(&EncodeToUtf32BE, false);
+  RunFromMemory();
+}
+
+TEST_F(EncodingTest, UTF32BE_BOM_memory) {
+  SetUpEncoding(&EncodeToUtf32BE, true);
+  RunFromMemory();
+}
+
+std::string EncodeUnitsToUtf16(const std::vector<int>& units, bool bigEndian) {
+  std::string bytes;
+  for (int unit : units) {
+    bytes += Byte(bigEndian ? unit >> 8 : unit & 0xFF);
+    bytes += Byte(bigEndian ? unit & 0xFF : unit >> 8);
+  }
+  return bytes;
+}
+
+std::string LoadScalarFromStream(const std::string& input) {
+  std::stringstream stream(input);
+  return Load(stream)["x"].as<std::string>();
+}
+
+TEST(TranscodingTest, UTF16InvalidSurrogates) {
+  // lone low, high followed by non-surrogate, high followed by high (which
+  // then pairs up), and eof (which is replaced too)
+  const std::vector<int> units = {0xFEFF, 'x',    ':',    ' ',    'a',
+                                  0xDC00, 'b',    0xD800, 'c',    0xD800,
+                                  0xD801, 0xDC01, 0x04,   'd',    'e',
+                                  'f',    'g',    'h',    'i',    'j',
+                                  'k',    'l',    'm',    'n',    'o'};
+  const std::string expected =
+      "a\xEF\xBF\xBD"
+      "b\xEF\xBF\xBD"
+      "c\xEF\xBF\xBD\xF0\x90\x90\x81\xEF\xBF\xBD"
+      "defghijklmno";
+
+  for (bool bigEndian : {false, true}) {
+    const std::string input = EncodeUnitsToUtf16(units, bigEndian);
+    EXPECT_EQ(expected, Load(input)["x"].as<std::string>());
+    EXPECT_EQ(expected, LoadScalarFromStream(input));
+  }
+}
+
+TEST(TranscodingTest, UTF16SurrogatePairsAcrossReads) {
+  // long enough that pairs are split between blocks of input
+  std::vector<int> units = {0xFEFF, 'x', ':', ' '};
+  std::string expected;
+  for (int i = 0; i < 3000; i++) {
+    units.push_back(0xD83D);
+    units.push_back(0xDE00);
+    expected += "\xF0\x9F\x98\x80";
+  }
+  // and a dangling high surrogate at the very end
+  units.push_back(0xD83D);
+  expected += "\xEF\xBF\xBD";
+
+  for (bool bigEndian : {false, true}) {
+    const std::string input = EncodeUnitsToUtf16(units, bigEndian);
+    EXPECT_EQ(expected, Load(input)["x"].as<std::string>());
+    EXPECT_EQ(expected, LoadScalarFromStream(input));
+  }
+}
+
+TEST(TranscodingTest, UTF32) {
+  // ASCII (including eof, which is replaced), then the rest of the planes
+  for (EncodingFn encoding : {&EncodeToUtf32LE, &EncodeToUtf32BE}) {
+    std::stringstream input;
+    std::string expected;
+    for (int ch : {0xFEFF, int('x'), int(':'), int(' ')}) {
+      encoding(input, ch);
+    }
+    for (int ch = 'a'; ch <= 'z'; ch++) {
+      encoding(input, ch);
+      expected += Byte(ch);
+    }
+    for (int ch : {0x04, 0xE9, 0x1F600}) {
+      encoding(input, ch);
+    }
+    expected += "\xEF\xBF\xBD\xC3\xA9\xF0\x9F\x98\x80";
+
+    EXPECT_EQ(expected, Load(input.str())["x"].as<std::string>());
+    EXPECT_EQ(expected, LoadScalarFromStream(input.str()));
+  }
+}
 }
 }
@@ -1,5 +1,8 @@
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
+#include <cstdio>
+#include <fstream>
+
 #include "gtest/gtest.h"
 
 namespace YAML {
@@ -454,6 +457,19 @@ TEST(LoadNodeTest, BlockCREncoded) {
   EXPECT_EQ(1, node["followup"].as<int>());
 }
 
+TEST(LoadNodeTest, LongScalars) {
+  const std::string word(100, 'x');
+  Node node = Load("plain: " + word + " " + word + "\n" +
+                   "single: '" + word + "''s   \n  " + word + "'\n" +
+                   "double: \"" + word + "\\t" + word + "\"\n" +
+                   "followup: 1");
+  EXPECT_EQ(word + " " + word, node["plain"].as<std::string>());
+  EXPECT_EQ(word + "'s " + word, node["single"].as<std::string>());
+  EXPECT_EQ(word + "\t" + word, node["double"].as<std::string>());
+  EXPECT_EQ(4, node["followup"].Mark().line);
+  EXPECT_EQ(10, node["followup"].Mark().column);
+}
+
 TEST(LoadNodeTest, IncorrectSeqEnd) {
   EXPECT_THROW(Load("[foo]_bar"), ParserException);
 }
@@ -462,5 +478,393 @@ TEST(LoadNodeTest, NonUniqueMapKey) {
   EXPECT_THROW(Load("{a: A, b: B, a: A}"), NonUniqueMapKey);
 }
 
+TEST(LoadNodeTest, NonUniqueMapKeyInLargeMap) {
+  std::string input = "{";
+  for (int i = 0; i < 1000; i++)
+    input += "key" + std::to_string(i) + ": " + std::to_string(i) + ", ";
+  EXPECT_EQ(1000, Load(input + "}").size());
+  EXPECT_THROW(Load(input + "key500: again}"), NonUniqueMapKey);
+}
+
+TEST(LoadNodeTest, LoadFile) {
+  const std::string filename = ::testing::TempDir() + "load_node_test.yaml";
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << "foo: bar\nseq: [1, 2]\n---\nbaz";
+  }
+
+  Node node = LoadFile(filename);
+  EXPECT_EQ("bar", node["foo"].as<std::string>());
+  EXPECT_EQ(2, node["seq"][1].as<int>());
+
+  std::vector<Node> docs = LoadAllFromFile(filename);
+  ASSERT_EQ(2, docs.size());
+  EXPECT_EQ("bar", docs[0]["foo"].as<std::string>());
+  EXPECT_EQ("baz", docs[1].as<std::string>());
+
+  std::remove(filename.c_str());
+}
+
+TEST(LoadNodeTest, LoadEmptyFile) {
+  const std::string filename = ::testing::TempDir() + "load_node_empty.yaml";
+  { std::ofstream fout(filename, std::ios::binary); }
+
+  EXPECT_TRUE(LoadFile(filename).IsNull());
+  EXPECT_TRUE(LoadAllFromFile(filename).empty());
+
+  std::remove(filename.c_str());
+}
+
+TEST(LoadNodeTest, LoadMissingFile) {
+  const std::string filename = ::testing::TempDir() + "load_node_missing.yaml";
+  EXPECT_THROW(LoadFile(filename), BadFile);
+  EXPECT_THROW(LoadAllFromFile(filename), BadFile);
+}
+
+void CollectMarks(const Node& node, std::vector<Mark>& marks) {
+  marks.push_back(node.Mark());
+  if (node.IsSequence()) {
+    for (const Node& child : node)
+      CollectMarks(child, marks);
+  } else if (node.IsMap()) {
+    for (const auto& entry : node) {
+      CollectMarks(entry.first, marks);
+      CollectMarks(entry.second, marks);
+    }
+  }
+}
+
+std::string ParallelTestInput(const std::string& newline) {
+  std::string input = "\xEF\xBB\xBF" "first: [a, b]" + newline;
+  for (int i = 0; i < 200; i++) {
+    const std::string n = std::to_string(i);
+    switch (i % 5) {
+      case 0:
+        input += "---" + newline + "key: &a" + n + " " + n + newline +
+                 "ref: *a" + n + newline;
+        break;
+      case 1:
+        input += "--- |" + newline + "  literal " + n + newline + "  ---x" +
+                 newline;
+        break;
+      case 2:
+        input += "---" + newline + "- 'quoted" + newline + "  " + n + "'" +
+                 newline + "..." + newline + "# between" + newline +
+                 "bare: " + n + newline;
+        break;
+      case 3:
+        input += "--- {a: " + n + ", b: [c, d]}" + newline;
+        break;
+      default:
+        input += "---" + newline + "---\t# empty" + newline;
+        break;
+    }
+  }
+  return input;
+}
+
+void ExpectSameDocuments(const std::vector<Node>& expected,
+                         const std::vector<Node>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(Dump(expected[i]), Dump(actual[i])) << i;
+
+    std::vector<Mark> expectedMarks;
+    CollectMarks(expected[i], expectedMarks);
+    std::vector<Mark> actualMarks;
+    CollectMarks(actual[i], actualMarks);
+    ASSERT_EQ(expectedMarks.size(), actualMarks.size()) << i;
+    for (std::size_t j = 0; j < expectedMarks.size(); j++) {
+      EXPECT_EQ(expectedMarks[j].pos, actualMarks[j].pos) << i;
+      EXPECT_EQ(expectedMarks[j].line, actualMarks[j].line) << i;
+      EXPECT_EQ(expectedMarks[j].column, actualMarks[j].column) << i;
+    }
+  }
+}
+
+TEST(LoadNodeTest, LoadAllParallel) {
+  for (const std::string newline : {"\n", "\r\n", "\r"}) {
+    const std::string input = ParallelTestInput(newline);
+    const std::vector<Node> expected = LoadAll(input);
+    for (std::size_t workers : {1, 2, 4, 0})
+      ExpectSameDocuments(expected, LoadAllParallel(input, workers));
+  }
+}
+
+TEST(LoadNodeTest, LoadAllParallelFallsBack) {
+  // directives, which carry over to later documents
+  const std::string tags = "%TAG !e! tag:e,2000:\n--- !e!a a\n--- !e!b b\n";
+  ExpectSameDocuments(LoadAll(tags), LoadAllParallel(tags, 4));
+
+  // errors, which are thrown as if on one thread
+  const std::string input = ParallelTestInput("\n");
+  for (const std::string error :
+       {"--- [a\n", "--- 'a\n", "--- \"a\n---\nb\"\n", "--- a: b\n  c\n"}) {
+    std::string expected;
+    try {
+      LoadAll(input + error + input);
+    } catch (const ParserException& e) {
+      expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty()) << error;
+
+    try {
+      LoadAllParallel(input + error + input, 4);
+      ADD_FAILURE() << error;
+    } catch (const ParserException& e) {
+      EXPECT_EQ(expected, e.what());
+    }
+  }
+}
+
+TEST(LoadNodeTest, LoadAllFromFileParallel) {
+  const std::string filename =
+      ::testing::TempDir() + "load_node_parallel.yaml";
+  const std::string input = ParallelTestInput("\n");
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << input;
+  }
+
+  ExpectSameDocuments(LoadAll(input), LoadAllFromFileParallel(filename, 4));
+  std::remove(filename.c_str());
+  EXPECT_THROW(LoadAllFromFileParallel(filename), BadFile);
+}
+
+std::string LargeMapTestInput(const std::string& newline) {
+  std::string input = "\xEF\xBB\xBF" "--- # inventory" + newline;
+  for (int i = 0; i < 300; i++) {
+    const std::string n = std::to_string(i);
+    input += "host" + n + ":" + newline;
+    switch (i % 4) {
+      case 0:
+        input += "  name: a" + n + newline + "  tags: [x, y]" + newline;
+        break;
+      case 1:
+        input += "- 'quoted" + newline + "  " + n + "'" + newline +
+                 "# comment" + newline + "- |" + newline + "  literal" +
+                 newline + newline + "  text" + newline;
+        break;
+      case 2:
+        input += "  ? complex" + newline + "  : &a" + n + " value" + newline +
+                 "  again: *a" + n + newline;
+        break;
+      default:
+        input += "  plain" + newline + "   scalar " + n + newline;
+        break;
+    }
+  }
+  return input;
+}
+
+void ExpectSameDocument(const Node& expected, const Node& actual) {
+  ExpectSameDocuments(std::vector<Node>{expected}, std::vector<Node>{actual});
+}
+
+TEST(LoadNodeTest, LoadParallel) {
+  for (const std::string newline : {"\n", "\r\n", "\r"}) {
+    const std::string input = LargeMapTestInput(newline);
+    const Node expected = Load(input);
+    for (std::size_t workers : {1, 2, 4, 0})
+      ExpectSameDocument(expected, LoadParallel(input, workers));
+
+    // only the first document is loaded
+    const std::string more = input + "..." + newline + "--- [a, b" + newline;
+    ExpectSameDocument(expected, LoadParallel(more, 4));
+  }
+}
+
+TEST(LoadNodeTest, LoadParallelFallsBack) {
+  const std::string input = LargeMapTestInput("\n");
+
+  // aliases to earlier entries, and values that continue at column 0
+  for (const std::string tail :
+       {"alias: *a2\n", "flow: {a: b,\nc: d}\n", "quoted: \"a\nb\"\n"}) {
+    ExpectSameDocument(Load(input + tail), LoadParallel(input + tail, 4));
+  }
+
+  // and errors, which are thrown as if on one thread
+  for (const std::string tail :
+       {"host0: again\n", "flow: [a\n", "bad: - a\n"}) {
+    std::string expected;
+    try {
+      Load(input + tail + input);
+    } catch (const Exception& e) {
+      expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty()) << tail;
+
+    try {
+      LoadParallel(input + tail + input, 4);
+      ADD_FAILURE() << tail;
+    } catch (const Exception& e) {
+      EXPECT_EQ(expected, e.what());
+    }
+  }
+}
+
+TEST(LoadNodeTest, LoadFileParallel) {
+  const std::string filename =
+      ::testing::TempDir() + "load_node_parallel_map.yaml";
+  const std::string input = LargeMapTestInput("\n");
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << input;
+  }
+
+  ExpectSameDocument(Load(input), LoadFileParallel(filename, 4));
+  std::remove(filename.c_str());
+  EXPECT_THROW(LoadFileParallel(filename), BadFile);
+}
+
+TEST(LoadNodeTest, LoadPaths) {
+  const std::string input =
+      "apiVersion: v1\n"
+      "kind: Pod\n"
+      "metadata:\n"
+      "  name: web\n"
+      "  labels:\n"
+      "    app: web\n"
+      "spec:\n"
+      "  containers:\n"
+      "  - name: nginx\n"
+      "    image: \"nginx:1.25\"\n"
+      "  volumes:\n"
+      "  - name: data\n"
+      "  nodeName: 'it''s'\n"
+      "status:\n"
+      "- 'left out'\n";
+  const Node node =
+      LoadPaths(input, {{"spec", "containers"}, {"metadata", "name"},
+                        {"kind"}, {"missing", "key"}});
+
+  ASSERT_TRUE(node.IsMap());
+  EXPECT_EQ(3, node.size());
+  EXPECT_EQ("Pod", node["kind"].as<std::string>());
+  EXPECT_EQ(1, node["metadata"].size());
+  EXPECT_EQ("web", node["metadata"]["name"].as<std::string>());
+  EXPECT_EQ(1, node["spec"].size());
+  EXPECT_EQ(Dump(Load("- name: nginx\n  image: \"nginx:1.25\"\n")),
+            Dump(node["spec"]["containers"]));
+  EXPECT_FALSE(node["status"]);
+
+  // the lines that were skipped are still counted
+  const Mark mark = node["spec"]["containers"][0]["name"].Mark();
+  EXPECT_EQ(8, mark.line);
+  EXPECT_EQ(10, mark.column);
+
+  // the paths go through sequences, and flow maps too
+  const Node items = LoadPaths(
+      "items:\n- {name: a, x: [1, 2]}\n- y: b\n  name: c\n- d\n",
+      {{"items", "name"}});
+  EXPECT_EQ("items:\n  - {name: a}\n  - name: c\n  - d", Dump(items));
+
+  // everything, or nothing
+  EXPECT_EQ(Dump(Load(input)), Dump(LoadPaths(input, {{}})));
+  EXPECT_EQ(0, LoadPaths(input, {}).size());
+}
+
+TEST(LoadNodeTest, LoadPathsDoesntCheckWhatsSkipped) {
+  EXPECT_EQ(1, LoadPaths("bad: a: b\nok: 1\n", {{"ok"}})["ok"].as<int>());
+  EXPECT_THROW(LoadPaths("bad: a: b\nok: 1\n", {{"bad"}}), ParserException);
+  EXPECT_EQ(1, LoadPaths("bad: {a: 1}}\nok: 1\n", {{"ok"}})["ok"].as<int>());
+
+  // but an alias can still refer to an anchor there
+  EXPECT_EQ(1, LoadPaths("a: &x 1\nb: *x\n", {{"a"}, {"b"}})["b"].as<int>());
+  EXPECT_EQ(1, LoadPaths("a: *x\nb: &x 1\n", {{"b"}})["b"].as<int>());
+  EXPECT_THROW(LoadPaths("a: 1\nb: *x\n", {{"b"}}), ParserException);
+}
+
+TEST(LoadNodeTest, LoadPathsLoadsItAllForAnAliasToWhatsSkipped) {
+  const Node node = LoadPaths("skip: &a 1\nkeep: *a\n", {{"keep"}});
+  EXPECT_EQ(1, node["keep"].as<int>());
+  EXPECT_FALSE(node["skip"]);
+  EXPECT_EQ(1, node.size());
+
+  // and then removes what isn't on the paths, all the way down
+  const Node nested = LoadPaths(
+      "a: {x: &v [1, 2], y: 3}\nb: [{x: 1, z: *v}, {x: 2}]\n'c': 4\n"
+      "!!str d: 5\n",
+      {{"a", "x"}, {"b", "z"}, {"c"}, {"d"}});
+  EXPECT_EQ(3, nested.size());
+  EXPECT_EQ(1, nested["a"].size());
+  EXPECT_EQ(2, nested["a"]["x"][1].as<int>());
+  EXPECT_EQ(1, nested["b"][0].size());
+  EXPECT_EQ(2, nested["b"][0]["z"][1].as<int>());
+  EXPECT_EQ(0, nested["b"][1].size());
+  EXPECT_EQ(4, nested["c"].as<int>());
+}
+
+TEST(LoadNodeTest, LoadPathsSkipsValuesThatGoOnPastTheirLines) {
+  // flow collections and quoted scalars can go on at any indentation
+  const std::vector<std::string> skipped = {
+      "{\n  a: 1\n}", "[\n  1\n]", "\"a\nb\"", "'a\nb'",
+      "[a,\nb]",       "\n  a: [x,\ny]", "'it''s\n'", "\"\\\"\n\"",
+      "|\n  it's [ open",   "\n  - >-\n    \"a\n  - [\nb]",
+      "\n\t1"};
+  for (const std::string& value : skipped) {
+    const std::string input = "skip: " + value + "\nkeep: 1\n";
+    ASSERT_EQ(1, Load(input)["keep"].as<int>()) << input;
+    const Node node = LoadPaths(input, {{"keep"}});
+    EXPECT_EQ(1, node["keep"].as<int>()) << input;
+    EXPECT_FALSE(node["skip"]) << input;
+  }
+
+  // but a flow collection that isn't closed is still an error
+  EXPECT_THROW(LoadPaths("bad: [\nok: 1\n", {{"ok"}}), ParserException);
+}
+
+TEST(LoadNodeTest, Interning) {
+  const std::string input =
+      "- {name: a, kind: web, image: nginx}\n"
+      "- {name: b, kind: web, image: nginx, ? [x]: y}\n"
+      "- {name: c, kind: db, image: a-much-longer-image-name-than-that}\n";
+  const Node expected = Load(input);
+  for (Interning interning :
+       {Interning::None, Interning::Keys, Interning::KeysAndShortScalars}) {
+    const Node node = Load(input, interning);
+    EXPECT_EQ(Dump(expected), Dump(node));
+    EXPECT_EQ("nginx", node[1]["image"].as<std::string>());
+    EXPECT_THROW(Load("{a: 1, a: 2}", interning), NonUniqueMapKey);
+  }
+
+  // equal keys, and then equal short scalars, share their strings
+  const auto shared = [](const Node& lhs, const Node& rhs) {
+    return &lhs.Scalar() == &rhs.Scalar();
+  };
+  const Node none = Load(input, Interning::None);
+  EXPECT_FALSE(shared(none[0].begin()->first, none[1].begin()->first));
+  const Node keys = Load(input, Interning::Keys);
+  EXPECT_TRUE(shared(keys[0].begin()->first, keys[2].begin()->first));
+  EXPECT_FALSE(shared(keys[0]["kind"], keys[1]["kind"]));
+  const Node all = Load(input, Interning::KeysAndShortScalars);
+  EXPECT_TRUE(shared(all[0]["kind"], all[1]["kind"]));
+  EXPECT_FALSE(shared(all[0]["kind"], all[2]["kind"]));
+
+  // and changing one doesn't change the others
+  Node changed = all;
+  changed[0]["kind"] = "cache";
+  changed[2].begin()->first = "label";
+  EXPECT_EQ("cache", changed[0]["kind"].as<std::string>());
+  EXPECT_EQ("web", changed[1]["kind"].as<std::string>());
+  EXPECT_EQ("name", changed[1].begin()->first.as<std::string>());
+  EXPECT_EQ("label", changed[2].begin()->first.as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadFileInterning) {
+  const std::string filename = ::testing::TempDir() + "load_node_intern.yaml";
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << "- {a: 1}\n- {a: 2}\n";
+  }
+
+  const Node node = LoadFile(filename, Interning::Keys);
+  EXPECT_EQ(2, node[1]["a"].as<int>());
+  EXPECT_EQ(&node[0].begin()->first.Scalar(),
+            &node[1].begin()->first.Scalar());
+
+  std::remove(filename.c_str());
+}
+
 }  // namespace
 }  // namespace YAML
@@ -0,0 +1,161 @@
+#include "yaml-cpp/node/frozen.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+namespace {
+TEST(FrozenNodeTest, ReadsLikeTheNode) {
+  const Node node = Load("{name: foo, ports: [80, 443], ratio: !r 0.5}");
+  const FrozenNode frozen = Freeze(node);
+
+  EXPECT_TRUE(frozen.IsMap());
+  EXPECT_EQ(3, frozen.size());
+  EXPECT_EQ("foo", frozen["name"].Scalar());
+  EXPECT_EQ("foo", frozen["name"].as<std::string>());
+  EXPECT_EQ(0.5, frozen["ratio"].as<double>());
+  EXPECT_EQ("!r", frozen["ratio"].Tag());
+  EXPECT_EQ("?", frozen["name"].Tag());
+  EXPECT_EQ(EmitterStyle::Flow, frozen.Style());
+  EXPECT_TRUE(frozen["ports"].IsSequence());
+  EXPECT_EQ(443, frozen["ports"][1].as<int>());
+  EXPECT_EQ((std::vector<int>{80, 443}),
+            frozen["ports"].as<std::vector<int>>());
+  EXPECT_EQ(node["ports"].Mark().column, frozen["ports"].Mark().column);
+}
+
+TEST(FrozenNodeTest, DoesntChangeWithTheNode) {
+  Node node = Load("{a: 1}");
+  const FrozenNode frozen = Freeze(node);
+
+  node["a"] = 2;
+  node["b"] = 3;
+  EXPECT_EQ(1, frozen["a"].as<int>());
+  EXPECT_FALSE(frozen["b"]);
+  EXPECT_EQ(1, frozen.size());
+}
+
+TEST(FrozenNodeTest, Iterates) {
+  const FrozenNode frozen = Freeze(Load("{b: [x, y], a: [z]}"));
+
+  std::string keys;
+  std::string items;
+  for (const auto& kv : frozen) {
+    EXPECT_FALSE(kv.IsDefined());
+    keys += kv.first.Scalar().str();
+    for (const FrozenNode& item : kv.second)
+      items += item.Scalar().str();
+  }
+  EXPECT_EQ("ba", keys);
+  EXPECT_EQ("xyz", items);
+
+  FrozenNode::const_iterator it = frozen["b"].begin();
+  EXPECT_EQ("y", (++it)->Scalar());
+  EXPECT_EQ("x", (--it)->Scalar());
+  EXPECT_FALSE(it->first.IsDefined());
+}
+
+TEST(FrozenNodeTest, FindsKeys) {
+  std::string input = "{";
+  for (int i = 0; i < 100; i++)
+    input += "k" + std::to_string(99 - i) + ": " + std::to_string(i) + ", ";
+  input += "7: seven, '': empty, [x]: list}";
+  const FrozenNode frozen = Freeze(Load(input));
+
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(99 - i, frozen["k" + std::to_string(i)].as<int>());
+  EXPECT_EQ("seven", frozen[7].Scalar());
+  EXPECT_EQ("empty", frozen[""].Scalar());
+  EXPECT_FALSE(frozen["k100"]);
+  EXPECT_FALSE(frozen["[x]"]);
+}
+
+TEST(FrozenNodeTest, MissingKeys) {
+  const FrozenNode frozen = Freeze(Load("{a: [1]}"));
+
+  EXPECT_FALSE(frozen["x"]);
+  EXPECT_FALSE(frozen["a"][1]);
+  EXPECT_FALSE(frozen["a"]["x"]);
+  EXPECT_EQ(7, frozen["x"].as<int>(7));
+  EXPECT_THROW(frozen["x"].as<int>(), InvalidNode);
+  EXPECT_THROW(frozen["x"].Type(), InvalidNode);
+  EXPECT_THROW(frozen["x"]["y"], InvalidNode);
+  EXPECT_EQ(frozen["x"].begin(), frozen["x"].end());
+}
+
+TEST(FrozenNodeTest, EmptyNodes) {
+  const FrozenNode frozen = Freeze(Node());
+
+  EXPECT_TRUE(frozen.IsDefined());
+  EXPECT_TRUE(frozen.IsNull());
+  EXPECT_EQ(0, frozen.size());
+  EXPECT_EQ("", frozen.Scalar());
+  EXPECT_EQ("null", frozen.as<std::string>());
+  EXPECT_EQ(frozen.begin(), frozen.end());
+
+  EXPECT_TRUE(Freeze(Load("~")).IsNull());
+  const Node empty;
+  EXPECT_THROW(Freeze(empty["x"]), InvalidNode);
+}
+
+TEST(FrozenNodeTest, KeepsAliases) {
+  const FrozenNode frozen = Freeze(Load("{a: &x {b: 1}, c: *x}"));
+
+  EXPECT_TRUE(frozen["a"].is(frozen["c"]));
+  EXPECT_FALSE(frozen["a"].is(frozen["a"]["b"]));
+
+  const Node thawed = frozen.Thaw();
+  EXPECT_TRUE(thawed["a"].is(thawed["c"]));
+  EXPECT_EQ(1, thawed["c"]["b"].as<int>());
+  EXPECT_EQ("{a: &1 {b: 1}, c: *1}", Dump(thawed));
+}
+
+TEST(FrozenNodeTest, ThawsACopy) {
+  const FrozenNode frozen = Freeze(Load("[a, {b: c}]"));
+
+  Node thawed = frozen.Thaw();
+  thawed[1]["b"] = "d";
+  EXPECT_EQ("d", thawed[1]["b"].as<std::string>());
+  EXPECT_EQ("c", frozen[1]["b"].Scalar());
+  EXPECT_EQ("c", frozen[1].Thaw()["b"].as<std::string>());
+}
+
+TEST(FrozenNodeTest, ReadsConcurrently) {
+  std::string input = "{";
+  for (int i = 0; i < 200; i++)
+    input += "k" + std::to_string(i) + ": [" + std::to_string(i) + ", x], ";
+  input += "}";
+  const FrozenNode frozen = Freeze(Load(input));
+
+  // every thread reads all of it, through its own copies and shared ones
+  std::atomic<int> failures(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&frozen, &failures] {
+      const FrozenNode copy = frozen;
+      for (int round = 0; round < 20; round++) {
+        int sum = 0;
+        for (const auto& kv : copy)
+          sum += kv.second[0].as<int>() + (kv.second[1].Scalar() == "x");
+        for (int i = 0; i < 200; i++) {
+          if (frozen["k" + std::to_string(i)][0].as<int>() != i)
+            failures++;
+        }
+        if (sum != 199 * 200 / 2 + 200)
+          failures++;
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  EXPECT_EQ(0, failures);
+}
+}  // namespace
+}  // namespace YAML
@@ -326,6 +326,94 @@ TEST(NodeTest, MapForceInsert) {
   EXPECT_EQ(3, node.size());
 }
 
+TEST(NodeTest, LargeMap) {
+  Node node;
+  for (int i = 0; i < 1000; i++)
+    node["key" + std::to_string(i)] = i;
+  Node key;
+  node[key] = "late";
+  key = "late key";
+
+  const Node& cn = node;
+  EXPECT_EQ(1001, node.size());
+  EXPECT_EQ(123, node["key123"].as<int>());
+  EXPECT_EQ(456, cn[std::string("key456")].as<int>());
+  EXPECT_EQ("late", cn["late key"].as<std::string>());
+  EXPECT_FALSE(cn["key1000"]);
+
+  EXPECT_TRUE(node.remove("key123"));
+  EXPECT_FALSE(node.remove("key123"));
+  EXPECT_FALSE(cn["key123"]);
+  EXPECT_EQ(1000, node.size());
+
+  node.force_insert("key456", "second");
+  EXPECT_EQ(456, cn["key456"].as<int>());
+  EXPECT_TRUE(node.remove("key456"));
+  EXPECT_EQ("second", cn["key456"].as<std::string>());
+
+  int expected = 0;
+  for (const_iterator it = node.begin(); expected < 100; ++it, ++expected) {
+    if (expected == 123)
+      expected++;
+    EXPECT_EQ("key" + std::to_string(expected), it->first.as<std::string>());
+  }
+}
+
+TEST(NodeTest, LargeMapWithRenamedKeys) {
+  Node node;
+  for (int i = 0; i < 40; i++)
+    node["key" + std::to_string(i)] = i;
+
+  // renamed in place, so the map's index still has them under the old names
+  for (iterator it = node.begin(); it != node.end(); ++it) {
+    const std::string name = it->first.as<std::string>();
+    if (name == "key5") {
+      Node key = it->first;
+      key = "renamed";
+    } else if (name == "key6") {
+      Node key = it->first;
+      key = Node("key7");
+    }
+  }
+
+  const Node& cn = node;
+  EXPECT_EQ(5, cn["renamed"].as<int>());
+  EXPECT_FALSE(cn["key5"]);
+  EXPECT_EQ(5, node["renamed"].as<int>());
+  node["renamed"] = "again";
+  EXPECT_EQ(40, node.size());
+  EXPECT_EQ("again", cn["renamed"].as<std::string>());
+  EXPECT_FALSE(cn["key5"]);
+
+  // the first of the two keys is found, as without the index
+  EXPECT_EQ(6, node["key7"].as<int>());
+  EXPECT_TRUE(node.remove("renamed"));
+  EXPECT_FALSE(cn["renamed"]);
+  EXPECT_EQ(39, node.size());
+}
+
+TEST(NodeTest, LargeMapWithKeyRenamedAfterMerging) {
+  Node node;
+  for (int i = 0; i < 40; i++)
+    node["key" + std::to_string(i)] = i;
+  Node key = node.begin()->first;
+
+  // the map's memory is merged into a larger one, whose count of key changes
+  // goes on from both
+  Node other;
+  for (int i = 0; i < 100; i++)
+    other["other" + std::to_string(i)] = i;
+  other["map"] = node;
+  EXPECT_EQ(1, other["map"]["key1"].as<int>());
+
+  key = "renamed";
+  const Node& cn = other;
+  EXPECT_EQ(0, cn["map"]["renamed"].as<int>());
+  EXPECT_FALSE(cn["map"]["key0"]);
+  EXPECT_EQ(0, node["renamed"].as<int>());
+  EXPECT_EQ(40, node.size());
+}
+
 TEST(NodeTest, UndefinedConstNodeWithFallback) {
   Node node;
   const Node& cn = node;
@@ -893,6 +981,30 @@ TEST(NodeTest, KeyNodeExitsScope) {
   }
 }
 
+TEST(NodeTest, MergedNodesOutliveOtherNodes) {
+  Node third;
+  {
+    Node first;
+    for (int i = 0; i < 100; i++)
+      first.push_back(i);
+    Node second;
+    second["key"] = "value";
+    third["second"] = second;
+    first.push_back(second);
+  }
+  third["new"] = "node";
+  EXPECT_EQ("value", third["second"]["key"].as<std::string>());
+  EXPECT_EQ("node", third["new"].as<std::string>());
+}
+
+TEST(NodeTest, ManyNodes) {
+  Node node;
+  for (int i = 0; i < 10000; i++)
+    node[std::to_string(i)].push_back(i);
+  EXPECT_EQ(10000, node.size());
+  EXPECT_EQ(1234, node["1234"][0].as<int>());
+}
+
 TEST(NodeTest, DefaultNodeStyle) {
   Node node;
   EXPECT_EQ(EmitterStyle::Default, node.Style());
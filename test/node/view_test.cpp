@@ -0,0 +1,126 @@
+#include "yaml-cpp/node/view.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+TEST(NodeViewTest, ReadsLikeTheNode) {
+  const Node node = Load("{name: foo, ports: [80, 443], ratio: 0.5}");
+  const NodeView view(node);
+
+  EXPECT_TRUE(view.IsMap());
+  EXPECT_EQ(3, view.size());
+  EXPECT_EQ("foo", view["name"].Scalar());
+  EXPECT_EQ("foo", view["name"].as<std::string>());
+  EXPECT_EQ(0.5, view["ratio"].as<double>());
+  EXPECT_TRUE(view["ports"].IsSequence());
+  EXPECT_EQ(443, view["ports"][1].as<int>());
+  EXPECT_EQ(node["ports"].Mark().column, view["ports"].Mark().column);
+  EXPECT_EQ("?", view["name"].Tag());
+  EXPECT_EQ(EmitterStyle::Flow, view.Style());
+  EXPECT_TRUE(view["name"].is(NodeView(node["name"])));
+}
+
+TEST(NodeViewTest, ConvertsCollections) {
+  const Node node = Load("{ports: [80, 443], env: {a: 1, b: 2}}");
+  const NodeView view(node);
+
+  EXPECT_EQ((std::vector<int>{80, 443}),
+            view["ports"].as<std::vector<int>>());
+  const std::map<std::string, int> env{{"a", 1}, {"b", 2}};
+  EXPECT_EQ(env, (view["env"].as<std::map<std::string, int>>()));
+}
+
+TEST(NodeViewTest, DoesntConvertToNodes) {
+  // (which as() rejects, since they'd outlive the document's memory)
+  static_assert(detail::holds_node<Node>::value, "");
+  static_assert(detail::holds_node<std::vector<Node>>::value, "");
+  static_assert(detail::holds_node<std::map<std::string, Node>>::value, "");
+  static_assert(detail::holds_node<std::pair<int, std::vector<Node>>>::value,
+                "");
+  static_assert(!detail::holds_node<int>::value, "");
+  static_assert(!detail::holds_node<std::string>::value, "");
+  static_assert(!detail::holds_node<std::map<std::string, int>>::value, "");
+  const Node node = Load("[1]");
+  EXPECT_EQ(1, NodeView(node)[0].as<int>());
+}
+
+TEST(NodeViewTest, IteratesSequences) {
+  const Node node = Load("[a, b, c]");
+
+  std::string joined;
+  for (const NodeView item : NodeView(node))
+    joined += item.Scalar();
+  EXPECT_EQ("abc", joined);
+
+  NodeView::const_iterator it = NodeView(node).begin();
+  EXPECT_EQ("b", (++it)->Scalar());
+  EXPECT_EQ("a", (--it)->Scalar());
+  EXPECT_FALSE(it->first.IsDefined());
+}
+
+TEST(NodeViewTest, IteratesMaps) {
+  const Node node = Load("{a: 1, b: 2, c: 3}");
+
+  std::string keys;
+  int sum = 0;
+  for (const auto& kv : NodeView(node)) {
+    EXPECT_FALSE(kv.IsDefined());
+    keys += kv.first.Scalar();
+    sum += kv.second.as<int>();
+  }
+  EXPECT_EQ("abc", keys);
+  EXPECT_EQ(6, sum);
+}
+
+TEST(NodeViewTest, MissingKeys) {
+  const Node node = Load("{a: {b: 1}}");
+  const NodeView view(node);
+
+  EXPECT_FALSE(view["x"]);
+  EXPECT_FALSE(view["a"]["x"].IsDefined());
+  EXPECT_EQ(7, view["x"].as<int>(7));
+  EXPECT_THROW(view["x"].as<int>(), InvalidNode);
+  EXPECT_THROW(view["x"].Type(), InvalidNode);
+  EXPECT_THROW(view["x"]["y"], InvalidNode);
+  EXPECT_EQ(view["x"].begin(), view["x"].end());
+  EXPECT_EQ(1, view["a"]["b"].as<int>());
+}
+
+TEST(NodeViewTest, EmptyNodes) {
+  const Node node;
+  const NodeView view(node);
+
+  EXPECT_TRUE(view.IsDefined());
+  EXPECT_TRUE(view.IsNull());
+  EXPECT_EQ(0, view.size());
+  EXPECT_EQ("", view.Scalar());
+  EXPECT_EQ("null", view.as<std::string>());
+  EXPECT_EQ(view.begin(), view.end());
+  EXPECT_FALSE(view["x"]);
+
+  EXPECT_TRUE(NodeView().IsNull());
+}
+
+TEST(NodeViewTest, LastsAsLongAsTheDocument) {
+  const Node node = Load("{a: [1, 2], b: {c: 3}}");
+
+  NodeView items;
+  {
+    const Node a = node["a"];
+    items = NodeView(a);
+  }
+  int sum = 0;
+  for (const NodeView item : items)
+    sum += item.as<int>();
+  EXPECT_EQ(3, sum);
+  EXPECT_EQ(3, NodeView(node)["b"]["c"].as<int>());
+}
+}  // namespace
+}  // namespace YAML
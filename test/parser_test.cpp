@@ -1,11 +1,22 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <yaml-cpp/depthguard.h>
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/eventreader.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/refeventhandler.h"
 #include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/lineindex.h"
 #include "mock_event_handler.h"
 #include "gtest/gtest.h"
 
 using YAML::Parser;
 using YAML::MockEventHandler;
+using ::testing::_;
 using ::testing::NiceMock;
 using ::testing::StrictMock;
 
@@ -62,3 +73,563 @@ TEST(ParserTest, CVE_2019_6285) {
     NiceMock<MockEventHandler> handler;
     EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
 }
+
+namespace {
+// Records the events as text, so that they can be compared between parses.
+class RecordingEventHandler : public YAML::EventHandler {
+  public:
+    void OnDocumentStart(const YAML::Mark&) override { events += "+DOC "; }
+    void OnDocumentEnd() override { events += "-DOC "; }
+    void OnNull(const YAML::Mark&, YAML::anchor_t) override {
+        events += "~ ";
+    }
+    void OnAlias(const YAML::Mark&, YAML::anchor_t anchor) override {
+        events += "*" + std::to_string(anchor) + " ";
+    }
+    void OnScalar(const YAML::Mark& mark, const std::string& tag,
+                  YAML::anchor_t anchor, const std::string& value) override {
+        events += "=" + tag + "&" + std::to_string(anchor) + "@" +
+                  std::to_string(mark.pos) + ":" + value + " ";
+    }
+    void OnSequenceStart(const YAML::Mark&, const std::string& tag,
+                         YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value) override {
+        events += "+SEQ" + tag + "&" + std::to_string(anchor) + " ";
+    }
+    void OnSequenceEnd() override { events += "-SEQ "; }
+    void OnMapStart(const YAML::Mark&, const std::string& tag,
+                    YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value) override {
+        events += "+MAP" + tag + "&" + std::to_string(anchor) + " ";
+    }
+    void OnMapEnd() override { events += "-MAP "; }
+
+    std::string events;
+};
+
+const char* const kPushExample =
+    "%YAML 1.2\n"
+    "---\n"
+    "key: value\n"
+    "list: [a, &x b, *x]\n"
+    "block: |\n"
+    "  some text\n"
+    "...\n"
+    "--- !!str\n"
+    "second\n"
+    "---\n"
+    "- ~\n"
+    "- {c: d}\n";
+}  // namespace
+
+TEST(ParserTest, FeedMatchesWholeInput) {
+    RecordingEventHandler expected;
+    std::istringstream input{kPushExample};
+    Parser whole{input};
+    while (whole.HandleNextDocument(expected)) {
+    }
+
+    const std::string example = kPushExample;
+    for (std::size_t chunkSize : {1, 2, 3, 7, 100}) {
+        RecordingEventHandler handler;
+        Parser parser;
+        parser.Load(handler);
+        for (std::size_t i = 0; i < example.size(); i += chunkSize) {
+            parser.Feed(example.data() + i,
+                        std::min(chunkSize, example.size() - i));
+        }
+        parser.Finish();
+
+        EXPECT_EQ(expected.events, handler.events) << chunkSize;
+    }
+}
+
+TEST(ParserTest, FeedHandlesEventsEarly) {
+    RecordingEventHandler handler;
+    Parser parser;
+    parser.Load(handler);
+
+    const std::string first = "- a\n- b\n";
+    parser.Feed(first.data(), first.size());
+    EXPECT_EQ("+DOC +SEQ?&0 =?&0@2:a ", handler.events);
+
+    const std::string second = "- c\n";
+    parser.Feed(second.data(), second.size());
+    EXPECT_EQ("+DOC +SEQ?&0 =?&0@2:a =?&0@6:b ", handler.events);
+
+    parser.Finish();
+    EXPECT_EQ("+DOC +SEQ?&0 =?&0@2:a =?&0@6:b =?&0@10:c -SEQ -DOC ",
+              handler.events);
+}
+
+TEST(ParserTest, FeedThrowsParserErrors) {
+    NiceMock<MockEventHandler> handler;
+    Parser parser;
+    parser.Load(handler);
+
+    const std::string input = "[a, b";
+    parser.Feed(input.data(), input.size());
+    EXPECT_THROW(parser.Finish(), YAML::ParserException);
+
+    parser.Load(handler);
+    const std::string bad = "[a, b]]";
+    EXPECT_THROW(parser.Feed(bad.data(), bad.size()), YAML::ParserException);
+    parser.Feed(bad.data(), bad.size());  // ignored
+    parser.Finish();
+}
+
+TEST(ParserTest, FeedKeepsMarksAcrossDocuments) {
+    const std::string example =
+        "\xEF\xBB\xBF--- a\r\n--- b\r\n...\r\n%YAML 1.2\r\n---\r\n"
+        "- c\r\n- [d\r\n";
+    YAML::Mark expected;
+    try {
+        std::istringstream input{example};
+        Parser whole{input};
+        NiceMock<MockEventHandler> handler;
+        while (whole.HandleNextDocument(handler)) {
+        }
+        FAIL();
+    } catch (const YAML::ParserException& e) {
+        expected = e.mark;
+    }
+
+    for (std::size_t chunkSize : {1, 5, 100}) {
+        NiceMock<MockEventHandler> handler;
+        Parser parser;
+        parser.Load(handler);
+        try {
+            for (std::size_t i = 0; i < example.size(); i += chunkSize) {
+                parser.Feed(example.data() + i,
+                            std::min(chunkSize, example.size() - i));
+            }
+            parser.Finish();
+            FAIL() << chunkSize;
+        } catch (const YAML::ParserException& e) {
+            EXPECT_EQ(expected.pos, e.mark.pos) << chunkSize;
+            EXPECT_EQ(expected.line, e.mark.line) << chunkSize;
+            EXPECT_EQ(expected.column, e.mark.column) << chunkSize;
+        }
+    }
+}
+
+TEST(ParserTest, FeedHandlesEventsAsTheDocumentGoes) {
+    std::string example;
+    for (int i = 0; i < 2000; i++) {
+        example += "key" + std::to_string(i) + ":\n  name: item\n" +
+                   "  tags: [a, b]\n";
+    }
+
+    RecordingEventHandler handler;
+    Parser parser;
+    parser.Load(handler);
+    const std::size_t chunkSize = 256;
+    for (std::size_t i = 0; i < example.size(); i += chunkSize) {
+        const std::size_t sent = handler.events.size();
+        parser.Feed(example.data() + i,
+                    std::min(chunkSize, example.size() - i));
+        EXPECT_LT(sent, handler.events.size()) << i;
+    }
+    parser.Finish();
+    EXPECT_EQ(" -MAP -DOC ",
+              handler.events.substr(handler.events.size() - 11));
+}
+
+TEST(ParserTest, FeedSplitsUtf16CodeUnits) {
+    // "a: \U0001F600\n", with a surrogate pair
+    const std::string example("\xFF\xFE" "a\0:\0 \0\x3D\xD8\x00\xDE\n\0", 16);
+    RecordingEventHandler expected;
+    std::istringstream input{example};
+    Parser whole{input};
+    while (whole.HandleNextDocument(expected)) {
+    }
+
+    for (std::size_t chunkSize : {1, 3, 5}) {
+        RecordingEventHandler handler;
+        Parser parser;
+        parser.Load(handler);
+        for (std::size_t i = 0; i < example.size(); i += chunkSize) {
+            parser.Feed(example.data() + i,
+                        std::min(chunkSize, example.size() - i));
+        }
+        parser.Finish();
+        EXPECT_EQ(expected.events, handler.events) << chunkSize;
+    }
+}
+
+TEST(ParserTest, FeedHandlesEventsOnTheCallingThread) {
+    StrictMock<MockEventHandler> handler;
+    const std::thread::id caller = std::this_thread::get_id();
+    EXPECT_CALL(handler, OnDocumentStart(_)).WillOnce([&](const YAML::Mark&) {
+        EXPECT_EQ(caller, std::this_thread::get_id());
+    });
+    EXPECT_CALL(handler, OnScalar(_, "?", 0, "a"));
+    EXPECT_CALL(handler, OnDocumentEnd()).WillOnce([&] {
+        EXPECT_EQ(caller, std::this_thread::get_id());
+    });
+
+    Parser parser;
+    parser.Load(handler);
+    parser.Feed("a", 1);
+    parser.Finish();
+}
+
+TEST(ParserTest, FeedCanBeAbandoned) {
+    RecordingEventHandler handler;
+    {
+        Parser parser;
+        parser.Load(handler);
+        const std::string input = "- a\n- b";
+        parser.Feed(input.data(), input.size());
+    }
+    EXPECT_EQ("+DOC +SEQ?&0 =?&0@2:a ", handler.events);
+}
+
+namespace {
+// Records an event in the same form as RecordingEventHandler.
+std::string Record(const YAML::Event& event) {
+    const std::string anchor = "&" + std::to_string(event.anchor) + " ";
+    switch (event.type) {
+        case YAML::Event::DocumentStart:
+            return "+DOC ";
+        case YAML::Event::DocumentEnd:
+            return "-DOC ";
+        case YAML::Event::Null:
+            return "~ ";
+        case YAML::Event::Alias:
+            return "*" + std::to_string(event.anchor) + " ";
+        case YAML::Event::Scalar:
+            return "=" + event.tag.str() + "&" + std::to_string(event.anchor) +
+                   "@" + std::to_string(event.mark.pos) + ":" +
+                   event.value.str() + " ";
+        case YAML::Event::SequenceStart:
+            return "+SEQ" + event.tag.str() + anchor;
+        case YAML::Event::SequenceEnd:
+            return "-SEQ ";
+        case YAML::Event::MapStart:
+            return "+MAP" + event.tag.str() + anchor;
+        case YAML::Event::MapEnd:
+            return "-MAP ";
+    }
+    return "";
+}
+
+std::string ReadAll(YAML::EventReader& reader) {
+    std::string events;
+    YAML::Event event;
+    while (reader.Next(event)) {
+        events += Record(event);
+    }
+    return events;
+}
+}  // namespace
+
+TEST(EventReaderTest, MatchesEventHandler) {
+    const std::string examples[] = {
+        kPushExample,
+        "",
+        "a",
+        "[a, b: c, : d, e:]",
+        "{a, b: , c: d}",
+        "? a\n? b\n: c\n",
+        "- - - a\n    - b\n- !!str\n- &y\n- *y\n",
+        "--- a\n--- b\n...\n--- c\n",
+        "!foo &z [!bar x, y]\n",
+    };
+
+    for (const std::string& example : examples) {
+        RecordingEventHandler expected;
+        std::istringstream input{example};
+        Parser parser{input};
+        while (parser.HandleNextDocument(expected)) {
+        }
+
+        YAML::EventReader reader{example.data(), example.size()};
+        EXPECT_EQ(expected.events, ReadAll(reader)) << example;
+    }
+}
+
+TEST(EventReaderTest, Strings) {
+    std::istringstream input{"&a !!str b"};
+    YAML::EventReader reader{input};
+
+    YAML::Event event;
+    ASSERT_TRUE(reader.Next(event));
+    EXPECT_EQ(YAML::Event::DocumentStart, event.type);
+    ASSERT_TRUE(reader.Next(event));
+    EXPECT_EQ(YAML::Event::Scalar, event.type);
+    EXPECT_EQ(YAML::StringRef("b"), event.value);
+    EXPECT_EQ(YAML::StringRef("tag:yaml.org,2002:str"), event.tag);
+    EXPECT_EQ(YAML::StringRef("a"), event.anchorName);
+    EXPECT_EQ(1u, event.anchor);
+}
+
+TEST(EventReaderTest, Skip) {
+    const std::string example = "a: {b: [c, d], e: f}\ng: [h]\n";
+    YAML::EventReader reader{example.data(), example.size()};
+
+    YAML::Event event;
+    std::string events;
+    while (reader.Next(event)) {
+        events += Record(event);
+        if (event.type == YAML::Event::Scalar && event.value == "a") {
+            ASSERT_TRUE(reader.Next(event));
+            ASSERT_EQ(YAML::Event::MapStart, event.type);
+            reader.Skip();
+        }
+    }
+    EXPECT_EQ("+DOC +MAP?&0 =?&0@0:a =?&0@21:g +SEQ?&0 =?&0@25:h -SEQ -MAP "
+              "-DOC ",
+              events);
+}
+
+TEST(EventReaderTest, ThrowsParserErrors) {
+    const std::string example = "- a\n- [b, c\n";
+    YAML::EventReader reader{example.data(), example.size()};
+    EXPECT_THROW(ReadAll(reader), YAML::ParserException);
+}
+
+TEST(EventReaderTest, DeepRecursion) {
+    const std::string excessive_recursion(16384, '[');
+    YAML::EventReader reader{excessive_recursion.data(),
+                             excessive_recursion.size()};
+    EXPECT_THROW(ReadAll(reader), YAML::DeepRecursion);
+}
+
+namespace {
+// Records the events like RecordingEventHandler, from the string references.
+class RefRecordingEventHandler : public YAML::RefEventHandler {
+  public:
+    void OnDocumentStart(const YAML::Mark& mark) override {
+        recorder.OnDocumentStart(mark);
+    }
+    void OnDocumentEnd() override { recorder.OnDocumentEnd(); }
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        recorder.OnNull(mark, anchor);
+    }
+    void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        recorder.OnAlias(mark, anchor);
+    }
+    void OnScalar(const YAML::Mark& mark, YAML::StringRef tag,
+                  YAML::anchor_t anchor, YAML::StringRef value) override {
+        recorder.OnScalar(mark, tag.str(), anchor, value.str());
+        values.push_back(value.str());
+        valueData.push_back(value.data());
+    }
+    void OnSequenceStart(const YAML::Mark& mark, YAML::StringRef tag,
+                         YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value style) override {
+        recorder.OnSequenceStart(mark, tag.str(), anchor, style);
+    }
+    void OnSequenceEnd() override { recorder.OnSequenceEnd(); }
+    void OnMapStart(const YAML::Mark& mark, YAML::StringRef tag,
+                    YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value style) override {
+        recorder.OnMapStart(mark, tag.str(), anchor, style);
+    }
+    void OnMapEnd() override { recorder.OnMapEnd(); }
+    void OnAnchor(const YAML::Mark&, YAML::StringRef anchor_name) override {
+        anchors += anchor_name.str() + " ";
+    }
+
+    RecordingEventHandler recorder;
+    std::string anchors;
+    std::vector<std::string> values;
+    std::vector<const char*> valueData;
+};
+}  // namespace
+
+TEST(ParserTest, RefEventHandlerMatchesEventHandler) {
+    const std::string example = std::string(kPushExample) +
+                                "--- !foo &z [!bar x, y, *z, '']\n";
+
+    RecordingEventHandler expected;
+    std::istringstream input{example};
+    Parser parser{input};
+    while (parser.HandleNextDocument(expected)) {
+    }
+
+    RefRecordingEventHandler handler;
+    Parser refParser{example.data(), example.size()};
+    while (refParser.HandleNextDocument(handler)) {
+    }
+
+    EXPECT_EQ(expected.events, handler.recorder.events);
+    EXPECT_EQ("x z ", handler.anchors);
+}
+
+TEST(ParserTest, QuotedFlowScalarsInPlaceMatchStream) {
+    const std::string example =
+        "  \n{\"a\": \"x, y: {z}\", 'b': 'it''s\n  folded', \"c\": [1, \"\\t\\\"\","
+        " \"\\u00e9\\\n  tail\"], # comment\n \"d\": null}\n"
+        "--- [\"second\", {e: 'f'}]\n";
+
+    RecordingEventHandler expected;
+    std::istringstream input{example};
+    Parser parser{input};
+    while (parser.HandleNextDocument(expected)) {
+    }
+
+    RecordingEventHandler handler;
+    Parser inPlace{example.data(), example.size()};
+    while (inPlace.HandleNextDocument(handler)) {
+    }
+    EXPECT_EQ(expected.events, handler.events);
+}
+
+TEST(ParserTest, VerbatimScalarsReferToTheInput) {
+    const std::string example =
+        "plain: [one, 'two', \"three\", 'it''s', \"tab\\t\"]\n"
+        "folded: four\n  five\n";
+
+    RefRecordingEventHandler handler;
+    Parser parser{example.data(), example.size()};
+    while (parser.HandleNextDocument(handler)) {
+    }
+
+    const std::vector<std::string> values = {
+        "plain", "one", "two", "three", "it's", "tab\t", "folded", "four five"};
+    const std::vector<bool> verbatim = {true, true, true, true,
+                                        false, false, true, false};
+    ASSERT_EQ(values, handler.values);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        const bool inInput = handler.valueData[i] >= example.data() &&
+                             handler.valueData[i] < example.data() +
+                                                    example.size();
+        EXPECT_EQ(verbatim[i], inInput) << values[i];
+    }
+}
+
+TEST(ParserTest, KeyPathsSkipTheSameInMemoryAndStream) {
+    // in memory, block map values are skipped by their indentation; from a
+    // stream, token by token
+    const std::string example =
+        "kind: Pod\n"
+        "metadata:\n"
+        "  name: web\n"
+        "  labels: {app: web, tier: \"front\\tend\"}\n"
+        "spec:\n"
+        "  containers:\n"
+        "  - name: nginx\n"
+        "    ports: [80, 443]\n"
+        "  volumes:\n"
+        "  - name: data\n"
+        "    # a comment\n"
+        "\n"
+        "    emptyDir: {}\n"
+        "  nodeName: 'it''s'\n"
+        "status: |\n"
+        "  unbalanced [ and '\n"
+        "items: [{name: a, x: [1, 2]}, {y: b, name: c}, d: e]\n";
+    const std::vector<std::vector<std::string>> paths = {
+        {"spec", "containers"}, {"metadata", "name"}, {"items", "name"},
+        {"kind"}};
+
+    RecordingEventHandler expected;
+    std::istringstream input{example};
+    Parser parser{input};
+    ASSERT_TRUE(parser.HandleNextDocument(expected, paths));
+
+    RecordingEventHandler handler;
+    Parser inPlace{example.data(), example.size()};
+    ASSERT_TRUE(inPlace.HandleNextDocument(handler, paths));
+    EXPECT_EQ(expected.events, handler.events);
+    EXPECT_EQ(std::string::npos, handler.events.find("volumes"));
+    EXPECT_EQ(std::string::npos, handler.events.find("status"));
+    EXPECT_NE(std::string::npos, handler.events.find("nginx"));
+    EXPECT_FALSE(inPlace.HandleNextDocument(handler, paths));
+}
+
+namespace {
+// Records the marks of the events.
+class MarkRecordingEventHandler : public YAML::EventHandler {
+  public:
+    void OnDocumentStart(const YAML::Mark& mark) override {
+        marks.push_back(mark);
+    }
+    void OnDocumentEnd() override {}
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t) override {
+        marks.push_back(mark);
+    }
+    void OnAlias(const YAML::Mark& mark, YAML::anchor_t) override {
+        marks.push_back(mark);
+    }
+    void OnScalar(const YAML::Mark& mark, const std::string&, YAML::anchor_t,
+                  const std::string&) override {
+        marks.push_back(mark);
+    }
+    void OnSequenceStart(const YAML::Mark& mark, const std::string&,
+                         YAML::anchor_t, YAML::EmitterStyle::value) override {
+        marks.push_back(mark);
+    }
+    void OnSequenceEnd() override {}
+    void OnMapStart(const YAML::Mark& mark, const std::string&,
+                    YAML::anchor_t, YAML::EmitterStyle::value) override {
+        marks.push_back(mark);
+    }
+    void OnMapEnd() override {}
+
+    std::vector<YAML::Mark> marks;
+};
+}  // namespace
+
+TEST(ParserTest, OffsetMarks) {
+    const std::vector<std::string> inputs = {
+        "a: b\n# comment\nc:\n  - d  # comment\n  - {e: f, g: [h, i]}\n",
+        "a: b\r\n\r\nc:\r\n  - |\r\n    d\r\n    e\r\n  - 'f\r\n    g'\r\n",
+        "a: b\rc:\r  - d\r  - e\r",
+        "\xEF\xBB\xBF[a, {b: c},\n \"d\\\n  e\", f]",
+    };
+
+    for (const std::string& input : inputs) {
+        MarkRecordingEventHandler expected;
+        Parser lines{input.data(), input.size()};
+        while (lines.HandleNextDocument(expected)) {
+        }
+        MarkRecordingEventHandler offsets;
+        Parser parser{input.data(), input.size(), YAML::MarkMode::Offset};
+        while (parser.HandleNextDocument(offsets)) {
+        }
+
+        const YAML::LineIndex index(input.data(), input.size());
+        ASSERT_EQ(expected.marks.size(), offsets.marks.size()) << input;
+        for (std::size_t i = 0; i < expected.marks.size(); i++) {
+            const YAML::Mark& mark = offsets.marks[i];
+            EXPECT_EQ(expected.marks[i].pos, mark.pos) << input << i;
+            EXPECT_EQ(-1, mark.line) << input << i;
+            EXPECT_EQ(-1, mark.column) << input << i;
+
+            const YAML::Mark located = index.Locate(mark);
+            EXPECT_EQ(expected.marks[i].line, located.line) << input << i;
+            EXPECT_EQ(expected.marks[i].column, located.column) << input << i;
+        }
+    }
+}
+
+TEST(ParserTest, OffsetMarksAreLocatedInErrors) {
+    const std::vector<std::string> inputs = {
+        "a: b\n  c: d\n", "a:\n  - [b,\n  c\n", "a: b\n- c\n",
+        "a: 1\nb: \"c \\q\"\n",
+    };
+
+    for (const std::string& input : inputs) {
+        NiceMock<MockEventHandler> handler;
+        std::string expected;
+        try {
+            Parser parser{input.data(), input.size()};
+            parser.HandleNextDocument(handler);
+        } catch (const YAML::ParserException& e) {
+            expected = e.what();
+        }
+        ASSERT_FALSE(expected.empty()) << input;
+
+        try {
+            Parser parser{input.data(), input.size(), YAML::MarkMode::Offset};
+            parser.HandleNextDocument(handler);
+            ADD_FAILURE() << input;
+        } catch (const YAML::ParserException& e) {
+            EXPECT_EQ(expected, e.what());
+            EXPECT_GE(e.mark.line, 0);
+        }
+    }
+}
@@ -1,9 +1,12 @@
+#include "exp.h"
 #include "regex_yaml.h"
 #include "stream.h"
+#include "streamcharsource.h"
 #include "gtest/gtest.h"
 
 using YAML::RegEx;
 using YAML::Stream;
+using YAML::StreamCharSource;
 
 namespace {
 const auto MIN_CHAR = Stream::eof() + 1;
@@ -174,4 +177,57 @@ TEST(RegExTest, StringOr) {
 
   EXPECT_EQ(1, ex.Match(str));
 }
+
+TEST(RegExTest, CompiledMatchesTree) {
+  const std::vector<RegEx> exps = {
+      YAML::Exp::Break(),
+      YAML::Exp::BlankOrBreak(),
+      YAML::Exp::NotPrintable(),
+      YAML::Exp::DocStart(),
+      YAML::Exp::DocIndicator(),
+      YAML::Exp::BlockEntry(),
+      YAML::Exp::Key(),
+      YAML::Exp::KeyInFlow(),
+      YAML::Exp::ValueInFlow(),
+      YAML::Exp::Anchor(),
+      YAML::Exp::URI(),
+      YAML::Exp::PlainScalar(),
+      YAML::Exp::PlainScalarInFlow(),
+      YAML::Exp::EndScalarInFlow(),
+      YAML::Exp::ScanScalarEnd(),
+      YAML::Exp::EscBreak(),
+      YAML::Exp::Chomp(),
+      RegEx("abc").Compiled(),
+      (RegEx('a') + RegEx()).Compiled(),
+      (!RegEx("ab")).Compiled(),
+      RegEx().Compiled()};
+  const std::string alphabet("a b-:#,?%0\\\r\n\x04\xC2\x85");
+
+  std::vector<std::string> inputs(1);
+  for (int length = 1; length <= 3; length++) {
+    for (std::size_t i = 0, n = inputs.size(); i < n; i++) {
+      if (inputs[i].size() + 1 != static_cast<std::size_t>(length))
+        continue;
+      for (char ch : alphabet)
+        inputs.push_back(inputs[i] + ch);
+    }
+  }
+
+  for (const RegEx& ex : exps) {
+    for (const std::string& input : inputs) {
+      Stream stream(input.data(), input.size());
+      // the template walks the tree, rather than looking in the table
+      const int expected = ex.Match(StreamCharSource(stream));
+      EXPECT_EQ(expected, ex.Match(stream)) << "input: " << input;
+    }
+  }
+}
+
+TEST(RegExTest, ExpressionsAreCompiledWhole) {
+  // only a compiled expression can rule out a first character
+  EXPECT_TRUE(YAML::Exp::Key().CantStartWith('a'));
+  EXPECT_TRUE(YAML::Exp::KeyInFlow().CantStartWith('a'));
+  EXPECT_TRUE(YAML::Exp::EscBreak().CantStartWith('a'));
+  EXPECT_TRUE(YAML::Exp::BlockEntry().CantStartWith('a'));
+}
 }  // namespace
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "scanner.h"
+#include "token.h"
+#include "gtest/gtest.h"
+
+using YAML::Scanner;
+using YAML::Token;
+
+namespace {
+TEST(ScannerTest, IndentMarkersAreBoundedByDocument) {
+  std::string input;
+  for (int i = 0; i < 100000; i++)
+    input += "--- \n- a: [b, c]\n  d:\n    - e\n...\n";
+
+  Scanner scanner(input.data(), input.size());
+  std::size_t documents = 0;
+  std::size_t maxMarkers = 0;
+  while (!scanner.empty()) {
+    if (scanner.peek().type == Token::DOC_START)
+      documents++;
+    maxMarkers = std::max(maxMarkers, scanner.indentMarkerCount());
+    scanner.pop();
+  }
+
+  EXPECT_EQ(100000, documents);
+  EXPECT_LE(maxMarkers, 8);
+}
+
+std::vector<Token> ScanAll(Scanner& scanner) {
+  std::vector<Token> tokens;
+  for (; !scanner.empty(); scanner.pop())
+    tokens.push_back(scanner.peek());
+  return tokens;
+}
+
+TEST(ScannerTest, SkipsWhitespaceAndCommentsInRuns) {
+  const std::string longComment(5000, 'x');
+  const std::string input = "# " + longComment + "\r\n" +
+                            "a:   \t # trailing\r\n" +
+                            "  \t\r\n" +
+                            "  b:  [c,   # in flow\r\n" +
+                            "       d]\r\n" +
+                            "#\r\n" +
+                            "e: f #\r\n";
+
+  Scanner memory(input.data(), input.size());
+  const std::vector<Token> tokens = ScanAll(memory);
+
+  // the stream reads through a window that's much shorter than the comment
+  std::stringstream stream(input);
+  Scanner streamed(stream);
+  const std::vector<Token> streamedTokens = ScanAll(streamed);
+
+  ASSERT_EQ(tokens.size(), streamedTokens.size());
+  for (std::size_t i = 0; i < tokens.size(); i++) {
+    EXPECT_EQ(tokens[i].type, streamedTokens[i].type) << i;
+    EXPECT_EQ(tokens[i].mark.pos, streamedTokens[i].mark.pos) << i;
+    EXPECT_EQ(tokens[i].mark.line, streamedTokens[i].mark.line) << i;
+    EXPECT_EQ(tokens[i].mark.column, streamedTokens[i].mark.column) << i;
+  }
+
+  const auto scalar = [&tokens](const std::string& value) {
+    for (const Token& token : tokens) {
+      if (token.type == Token::PLAIN_SCALAR && token.text() == value)
+        return token.mark;
+    }
+    return YAML::Mark::null_mark();
+  };
+  EXPECT_EQ(1, scalar("a").line);
+  EXPECT_EQ(0, scalar("a").column);
+  EXPECT_EQ(3, scalar("b").line);
+  EXPECT_EQ(2, scalar("b").column);
+  EXPECT_EQ(4, scalar("d").line);
+  EXPECT_EQ(7, scalar("d").column);
+  EXPECT_EQ(6, scalar("e").line);
+  EXPECT_EQ(static_cast<int>(input.rfind('e')), scalar("e").pos);
+}
+}  // namespace
@@ -1,12 +1,12 @@
 #include "yaml-cpp/emitterstyle.h"
-#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/refeventhandler.h"
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 
-class NullEventHandler : public YAML::EventHandler {
+class NullEventHandler : public YAML::RefEventHandler {
  public:
   using Mark = YAML::Mark;
   using anchor_t = YAML::anchor_t;
@@ -17,12 +17,12 @@ class NullEventHandler : public YAML::EventHandler {
   void OnDocumentEnd() override {}
   void OnNull(const Mark&, anchor_t) override {}
   void OnAlias(const Mark&, anchor_t) override {}
-  void OnScalar(const Mark&, const std::string&, anchor_t,
-                const std::string&) override {}
-  void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+  void OnScalar(const Mark&, YAML::StringRef, anchor_t,
+                YAML::StringRef) override {}
+  void OnSequenceStart(const Mark&, YAML::StringRef, anchor_t,
                        YAML::EmitterStyle::value) override {}
   void OnSequenceEnd() override {}
-  void OnMapStart(const Mark&, const std::string&, anchor_t,
+  void OnMapStart(const Mark&, YAML::StringRef, anchor_t,
                   YAML::EmitterStyle::value) override {}
   void OnMapEnd() override {}
 };